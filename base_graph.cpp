@@ -2,231 +2,347 @@
 // Created by andrea on 09/09/18.
 //
 #include <iostream>
+#include <algorithm>
+#include <thread>
 #include "base_graph.h"
+#include "graph_builder.h"
 
 /**
- * This constructor generate takes as input the size of the graph and creates an internal structure
- * keeping a reference for each vertex and an incident matrix to know which vertex are connected.
+ * This constructor takes as input the size of the graph and creates an internal structure
+ * keeping a reference for each vertex. The arcs are stored in a compressed (forward-star) layout
+ * that is built from the edge list before solving, so the memory used is O(V + E).
  * @param vertices_count size of the graph.
  */
-BaseGraph::BaseGraph(int vertices_count) {
-    this->edge_matrix = new Edge**[vertices_count];
+template <typename Capacity>
+BaseGraph<Capacity>::BaseGraph(int vertices_count) {
     for (int i = 0; i < vertices_count; i++) {
         this->vertices.emplace_back(DEFAULT_LABEL, DEFAULT_EXCESS);
-        this->edge_matrix[i] = new Edge*[vertices_count];
-    }
-    // initialize pointers to null
-    for (int i = 0; i < this->vertices.size(); i++) {
-        for (int j = 0; j < this->vertices.size(); j++) {
-            this->edge_matrix[i][j] = nullptr;
-        }
     }
+    // the arcs are built lazily from the edge list
+    this->arcs_built = false;
+    this->source = -1;
+    this->sink = -1;
+    // the global relabel heuristic is disabled by default
+    this->global_relabel = false;
+    this->global_relabel_frequency = DEFAULT_GLOBAL_RELABEL_FREQUENCY;
+    // the gap heuristic is disabled by default
+    this->gap_heuristic = false;
+    this->solved = false;
     // initialize debug as disabled
     this->verbose = false;
+    // use all the available cores by default
+    this->threads_count = std::max(1, (int) std::thread::hardware_concurrency());
 }
 
-BaseGraph::~BaseGraph() {
-    for (int i = 0; i < this->vertices.size(); i++) {
-        for (int j = 0; j < this->vertices.size(); j++) {
-            delete this->edge_matrix[i][j];
+template <typename Capacity>
+BaseGraph<Capacity>::~BaseGraph() = default;
+
+/**
+ * Build the residual graph from the edge list. The first time the edges are frozen by a
+ * GraphBuilder, which merges parallel and antiparallel edges into one residual pair. When the
+ * graph has already been built the existing arcs keep their capacities and residual capacities:
+ * each new edge u->v generates a forward arc with the capacity of the edge and a reverse arc
+ * v->u with no capacity, appended after the existing arcs in the range of each vertex.
+ */
+template <typename Capacity>
+void BaseGraph<Capacity>::buildArcs() {
+    auto vertices_count = (int) this->vertices.size();
+    if (this->arc_head.empty()) {
+        GraphBuilder<Capacity>(vertices_count, std::move(this->edges)).build(*this);
+        return;
+    }
+    std::vector<int> old_first_arc;
+    old_first_arc.swap(this->first_arc);
+    auto old_arcs_count = (int) this->arc_head.size();
+    auto arcs_count = (int) (old_arcs_count + 2 * this->edges.size());
+    // count the arcs leaving each vertex
+    this->first_arc.assign(vertices_count + 1, 0);
+    for (int i = 0; i < vertices_count; i++) {
+        this->first_arc[i + 1] = old_first_arc[i + 1] - old_first_arc[i];
+    }
+    for (auto &edge : this->edges) {
+        this->first_arc[edge.u + 1] += 1;
+        this->first_arc[edge.v + 1] += 1;
+    }
+    for (int i = 0; i < vertices_count; i++) {
+        this->first_arc[i + 1] += this->first_arc[i];
+    }
+    std::vector<int> position(this->first_arc.begin(), this->first_arc.end() - 1);
+    // move the existing arcs, keeping their order inside each vertex
+    std::vector<int> old_head, old_reverse;
+    std::vector<Capacity> old_capacity, old_residual;
+    old_head.swap(this->arc_head);
+    old_reverse.swap(this->arc_reverse);
+    old_capacity.swap(this->arc_capacity);
+    old_residual.swap(this->arc_residual);
+    this->arc_head.resize(arcs_count);
+    this->arc_capacity.resize(arcs_count);
+    this->arc_residual.resize(arcs_count);
+    this->arc_reverse.resize(arcs_count);
+    std::vector<int> moved(old_arcs_count);
+    for (int i = 0; i < vertices_count; i++) {
+        for (int arc = old_first_arc[i]; arc < old_first_arc[i + 1]; arc++) {
+            moved[arc] = position[i]++;
+        }
+    }
+    for (int arc = 0; arc < old_arcs_count; arc++) {
+        this->arc_head[moved[arc]] = old_head[arc];
+        this->arc_capacity[moved[arc]] = old_capacity[arc];
+        this->arc_residual[moved[arc]] = old_residual[arc];
+        this->arc_reverse[moved[arc]] = moved[old_reverse[arc]];
+    }
+    // place each pair of new arcs in the range of its tail vertex
+    std::vector<int> added;
+    for (auto &edge : this->edges) {
+        int forward = position[edge.u]++;
+        int backward = position[edge.v]++;
+        this->arc_head[forward] = edge.v;
+        this->arc_capacity[forward] = edge.capacity;
+        this->arc_residual[forward] = edge.capacity;
+        this->arc_reverse[forward] = backward;
+        this->arc_head[backward] = edge.u;
+        this->arc_capacity[backward] = 0;
+        this->arc_residual[backward] = 0;
+        this->arc_reverse[backward] = forward;
+        added.push_back(forward);
+    }
+    // the arcs now hold the whole graph
+    this->edges.clear();
+    this->current_arc.assign(this->first_arc.begin(), this->first_arc.end() - 1);
+    this->arcs_built = true;
+    // on a solved graph the new arcs must not break the labeling
+    if (this->solved) {
+        for (int arc : added) {
+            if (isPositive(this->arc_residual[arc])) {
+                repairArc(arc);
+            }
         }
-        delete this->edge_matrix[i];
     }
-    delete this->edge_matrix;
 }
 
-void BaseGraph::printCurrentStatus() {
+template <typename Capacity>
+void BaseGraph<Capacity>::printCurrentStatus() {
     // print debug info if verbose is enabled
     if (this->verbose) {
         std::cout << "============================================================================ " << std::endl;
         for (int i = 0; i < vertices.size(); i++) {
             std::cout << "  [vertex " << i << "] => label: " << vertices[i].label << ", excess: " << vertices[i].excess << std::endl;
         }
-        std::cout << "  [incidence-matrix]" << std::endl;
+        std::cout << "  [arcs]" << std::endl;
         for (int i = 0; i < vertices.size(); i++) {
-            std::cout << "   | ";
-            for (int j = 0; j < vertices.size(); j++) {
-                std::cout << (this->edge_matrix[i][j] != nullptr ? "1" : "0") << " | ";
-            }
-            std::cout << std::endl;
-        }
-        std::cout << "  [flow-matrix]" << std::endl;
-        for (int i = 0; i < vertices.size(); i++) {
-            std::cout << "   | ";
-            for (int j = 0; j < vertices.size(); j++) {
-                Edge* edge = this->edge_matrix[i][j];
-                int flow = edge != nullptr ? edge->flow : 0;
-                if (flow >= 0) {
-                    if (flow <= 9) {
-                        std::cout << " " << flow << "  |";
-                    } else {
-                        std::cout << " " << flow << " |";
-                    }
-                } else {
-                    if (flow >= -9) {
-                        std::cout << " " << flow << "  |";
-                    } else {
-                        std::cout << flow << " |";
-                    }
+            for (int arc = this->first_arc[i]; arc < this->first_arc[i + 1]; arc++) {
+                // reverse arcs are not printed, their flow is the opposite of the forward one
+                if (this->arc_capacity[arc] > 0) {
+                    Capacity flow = this->arc_capacity[arc] - this->arc_residual[arc];
+                    std::cout << "   | " << i << " -> " << this->arc_head[arc] << " | flow: " << flow << " | capacity: " << this->arc_capacity[arc] << std::endl;
                 }
             }
-            std::cout << std::endl;
-        }
-        std::cout << "  [capacity-matrix]" << std::endl;
-        for (int i = 0; i < vertices.size(); i++) {
-            std::cout << "   | ";
-            for (int j = 0; j < vertices.size(); j++) {
-                Edge* edge = this->edge_matrix[i][j];
-                int capacity = edge != nullptr ? edge->capacity : 0;
-                if (capacity >= 0) {
-                    if (capacity <= 9) {
-                        std::cout << " " << capacity << "  |";
-                    } else {
-                        std::cout << " " << capacity << " |";
-                    }
-                } else {
-                    if (capacity >= -9) {
-                        std::cout << " " << capacity << "  |";
-                    } else {
-                        std::cout << capacity << " |";
-                    }
-                }
-            }
-            std::cout << std::endl;
         }
     }
 }
 
-void BaseGraph::setVerbose(bool verbose) {
+template <typename Capacity>
+void BaseGraph<Capacity>::setVerbose(bool verbose) {
     this->verbose = verbose;
 }
 
-void BaseGraph::preProcess(int s, int t) {
-    // the label of the source vertex is set to the number of vertices
-    // the label of all the other vertices (different from s) is set to 0
-    for (int i = 0; i < this->vertices.size(); i++) {
-        this->vertices[i].label = (i != s) ? 0 : (int) vertices.size();
-    }
-    // for each edge that goes from source to another vertex, the flow is set equal
-    // to the capacity and the excess of the destination vertex is set to the capacity
-    for (int i = 0; i < this->vertices.size(); i++) {
-        Edge* edge = this->edge_matrix[s][i];
-        if (edge != nullptr) {
-            edge->flow = edge->capacity;
-            this->vertices[i].excess = edge->capacity;
-            // the reverse link must be set to the inverse flow
-            this->edge_matrix[i][s]->flow = -edge->flow;
-        }
-    }
+template <typename Capacity>
+void BaseGraph<Capacity>::setGlobalRelabel(bool enabled) {
+    this->global_relabel = enabled;
+}
+
+template <typename Capacity>
+void BaseGraph<Capacity>::setGlobalRelabelFrequency(double frequency) {
+    this->global_relabel_frequency = frequency;
+}
+
+template <typename Capacity>
+void BaseGraph<Capacity>::setGapHeuristic(bool enabled) {
+    this->gap_heuristic = enabled;
 }
 
-int BaseGraph::getActiveNode(int s, int t) {
-    // this method must be differently implemented in each variation of
-    // the graph: this basic implementation will not return any vertex.
-    return NO_ACTIVE_NODE_FOUND;
+template <typename Capacity>
+void BaseGraph<Capacity>::setThreadCount(int threads_count) {
+    this->threads_count = std::max(1, threads_count);
 }
 
 /**
- * Try to push the overflowing flow from node u to all the connected nodes.
- * @param u index of the node that have overflowing flow to push.
- * @return if at least one admissible arc exists.
+ * Capacities and excesses are compared through the traits of their type, so that
+ * floating point amounts close to zero are considered as zero.
+ * @param value the amount to check.
+ * @return if the amount is greater than zero.
  */
-bool BaseGraph::pushFlow(int u) {
-    // iterate all the adjacent nodes
-    for (int i = 0; i < this->vertices.size(); i++) {
-        Edge* edge = this->edge_matrix[u][i];
-        if (edge != nullptr) {
-            // vertex i is adjacent to vertex u
-            if (edge->flow < edge->capacity) {
-                // if flow is equal to capacity the push cannot be done
-                if (this->vertices[u].label > this->vertices[i].label) {
-                    // the push can be done only if the label of the overflowing
-                    // vertex if higher than the label of the adjacent one.
-                    // the amount of flow that can be sent is equal to the minimum
-                    // between the remaining flow on edge and excess flow.
-                    int flow = std::min(edge->capacity - edge->flow, this->vertices[u].excess);
-                    // this flow can be sent from vertex u to vertex i.
-                    // the excessive flow in node u must be reduced.
-                    this->vertices[u].excess -= flow;
-                    // the incoming flow in node i must be added.
-                    this->vertices[i].excess += flow;
-                    // the flow on edge u->i must be increased.
-                    edge->flow += flow;
-                    // also the reverse edge must be updated.
-                    this->edge_matrix[i][u]->flow -= flow;
-                    // one arc has been found and some flow has been pushed
-                    // so we can exit the cycle and return success.
-                    if (this->verbose) {
-                        std::cout << "=> Flow moved from " << u << " to " << i << " by " << flow << " units" << std::endl;
-                    }
-                    return true;
-                }
-            }
-        }
-    }
-    // if no push has been done, return false
-    return false;
+template <typename Capacity>
+bool BaseGraph<Capacity>::isPositive(Capacity value) {
+    return CapacityTraits<Capacity>::isPositive(value);
 }
 
-bool BaseGraph::relabel(int u) {
-    // we have to look for the minimum label between the adjacent nodes
-    int minimum = -1;
-    // do the iteration
-    for (int i = 0; i < this->vertices.size(); i++) {
-        Edge *edge = this->edge_matrix[u][i];
-        if (edge != nullptr) {
-            // ensure that this edge is not full
-            if (edge->flow < edge->capacity) {
-                // obtain the label for this adjacent node
-                int label = this->vertices[i].label;
-                if (minimum == -1 || label < minimum) {
-                    // the label of the adjacent node is the minimum
-                    minimum = label;
-                    this->vertices[u].label = label + 1;
-                }
+/**
+ * Split the vertices using the current residual graph: the ones that can still reach the sink
+ * are found with a backward breadth-first search from it, all the others are on the source side.
+ * This holds both for a maximum flow and for a preflow at the end of the first phase, where a
+ * search from the source could miss the vertices that hold some excess.
+ * @return the source side of the cut and the saturated arcs leaving it.
+ */
+template <typename Capacity>
+MinimumCut<Capacity> BaseGraph<Capacity>::extractMinimumCut() {
+    std::vector<bool> sink_side(this->vertices.size(), false);
+    std::vector<int> queue(1, this->sink);
+    sink_side[this->sink] = true;
+    for (int head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int arc = this->first_arc[w]; arc < this->first_arc[w + 1]; arc++) {
+            int i = this->arc_head[arc];
+            if (!sink_side[i] && isPositive(this->arc_residual[this->arc_reverse[arc]])) {
+                sink_side[i] = true;
+                queue.push_back(i);
             }
         }
     }
-    // return if vertex has been relabeled
-    return minimum != -1;
-}
-
-void BaseGraph::addEdge(int u, int v, int capacity) {
-    this->edge_matrix[u][v] = new Edge(DEFAULT_FLOW, capacity);
-    this->edge_matrix[v][u] = new Edge(-DEFAULT_FLOW, 0);
-}
-
-int BaseGraph::getMaximumFlow(int s, int t) {
-    // the algorithm start pre-processing input data
-    preProcess(s, t);
-    // print current status after pre-processing
-    printCurrentStatus();
-    // enter the main cycle
-    int cycles = 0;
-    int activeNode = getActiveNode(s, t);
-    while (activeNode != NO_ACTIVE_NODE_FOUND) {
-        // an active node has been found
-        if (this->verbose) {
-            std::cout << "=> Current active node: " << activeNode << std::endl;
+    MinimumCut<Capacity> cut;
+    cut.value = 0;
+    for (int i = 0; i < this->vertices.size(); i++) {
+        if (sink_side[i]) {
+            continue;
         }
-        // try to push some flow in adjacent nodes
-        if (!pushFlow(activeNode)) {
-            // no admissible arc found
-            if (this->verbose) {
-                std::cout << "=> No admissible arc found, relabeling node " << activeNode << std::endl;
+        cut.source_side.push_back(i);
+        for (int arc = this->first_arc[i]; arc < this->first_arc[i + 1]; arc++) {
+            if (this->arc_capacity[arc] > 0 && sink_side[this->arc_head[arc]]) {
+                cut.arcs.emplace_back(i, this->arc_head[arc], this->arc_capacity[arc]);
+                cut.value += this->arc_capacity[arc];
             }
-            // relabel the node
-            relabel(activeNode);
         }
-        // print current status after pre-processing
-        printCurrentStatus();
-        // check for another active node
-        activeNode = getActiveNode(s, t);
-        cycles += 1;
     }
-    if (this->verbose) {
-        std::cout << "=> Cycles count: " << cycles << std::endl;
+    return cut;
+}
+
+template <typename Capacity>
+void BaseGraph<Capacity>::addEdge(int u, int v, Capacity capacity) {
+    this->edges.emplace_back(u, v, capacity);
+    // the new edge is turned into arcs before the next run
+    this->arcs_built = false;
+}
+
+/**
+ * Set the capacity from u to v, adding the edge if the two vertices are not connected yet.
+ * When the graph has already been solved the current preflow and labels are repaired around
+ * the arc, so that resolveMaximumFlow can continue from them instead of starting over.
+ * @param u index of the tail vertex.
+ * @param v index of the head vertex.
+ * @param capacity the new capacity, all the other arcs from u to v get no capacity.
+ */
+template <typename Capacity>
+void BaseGraph<Capacity>::updateEdgeCapacity(int u, int v, Capacity capacity) {
+    if (!this->arcs_built) {
+        buildArcs();
+    }
+    bool found = false;
+    for (int arc = this->first_arc[u]; arc < this->first_arc[u + 1]; arc++) {
+        if (this->arc_head[arc] == v) {
+            setArcCapacity(arc, found ? 0 : capacity);
+            found = true;
+        }
     }
-    // no more active node found, return the maximum flow
-    return this->vertices[t].excess;
-}
\ No newline at end of file
+    if (!found && isPositive(capacity)) {
+        addEdge(u, v, capacity);
+        buildArcs();
+    }
+}
+
+template <typename Capacity>
+void BaseGraph<Capacity>::removeEdge(int u, int v) {
+    updateEdgeCapacity(u, v, 0);
+}
+
+/**
+ * Move the graph and the settings into another solver of the same size, which can be of a
+ * different variation. The residual capacities are kept, but the result of the last run is not.
+ * @param target the graph receiving the edges and the arcs, this one is left empty.
+ */
+template <typename Capacity>
+void BaseGraph<Capacity>::moveTo(BaseGraph<Capacity> &target) {
+    target.vertices = std::move(this->vertices);
+    target.edges = std::move(this->edges);
+    target.first_arc = std::move(this->first_arc);
+    target.arc_head = std::move(this->arc_head);
+    target.arc_capacity = std::move(this->arc_capacity);
+    target.arc_residual = std::move(this->arc_residual);
+    target.arc_reverse = std::move(this->arc_reverse);
+    target.current_arc = std::move(this->current_arc);
+    target.arcs_built = this->arcs_built;
+    copySettings(target);
+    target.solved = false;
+    this->arcs_built = false;
+    this->solved = false;
+}
+
+/**
+ * Give another graph the same settings, without touching its edges.
+ * @param target the graph receiving the settings.
+ */
+template <typename Capacity>
+void BaseGraph<Capacity>::copySettings(BaseGraph<Capacity> &target) const {
+    target.verbose = this->verbose;
+    target.threads_count = this->threads_count;
+    target.global_relabel = this->global_relabel;
+    target.global_relabel_frequency = this->global_relabel_frequency;
+    target.gap_heuristic = this->gap_heuristic;
+}
+
+/**
+ * Called when the capacity of an arc changes. Graphs that cannot repair the result of the last
+ * run only store the new capacity, and the next resolve starts over.
+ * @param arc index of the arc.
+ * @param capacity the new capacity of the arc.
+ */
+template <typename Capacity>
+void BaseGraph<Capacity>::setArcCapacity(int arc, Capacity capacity) {
+    this->arc_capacity[arc] = capacity;
+    this->solved = false;
+}
+
+/**
+ * Called when an arc added to a solved graph has some residual capacity.
+ * @param arc index of the new arc.
+ */
+template <typename Capacity>
+void BaseGraph<Capacity>::repairArc(int arc) {
+    this->solved = false;
+}
+
+/**
+ * Compute a minimum s-t cut from the residual graph left by a maximum flow.
+ * @param s index of the source vertex.
+ * @param t index of the sink vertex.
+ * @return the minimum cut between s and t.
+ */
+template <typename Capacity>
+MinimumCut<Capacity> BaseGraph<Capacity>::getMinimumCut(int s, int t) {
+    getMaximumFlow(s, t);
+    return extractMinimumCut();
+}
+
+/**
+ * Compute again the maximum flow between the source and the sink of the last run, after some
+ * capacities have been updated. This basic implementation solves the graph from scratch.
+ * @return the value of the maximum flow.
+ */
+template <typename Capacity>
+Capacity BaseGraph<Capacity>::resolveMaximumFlow() {
+    return getMaximumFlow(this->source, this->sink);
+}
+
+template <typename Capacity>
+MinimumCut<Capacity> BaseGraph<Capacity>::resolveMinimumCut() {
+    return getMinimumCut(this->source, this->sink);
+}
+
+/**
+ * @return the counters of the last run, all zero when the graph does not collect them.
+ */
+template <typename Capacity>
+SolverStatistics BaseGraph<Capacity>::getStatistics() {
+    return SolverStatistics {};
+}
+
+INSTANTIATE_FOR_CAPACITIES(BaseGraph)
\ No newline at end of file
@@ -6,6 +6,8 @@
 #define ADVANCEDALGORITHMSPROJECT_GRAPH_H
 
 #include <vector>
+#include "capacity_traits.h"
+#include "solver_statistics.h"
 
 #define DEFAULT_LABEL 0
 #define DEFAULT_EXCESS 0
@@ -13,49 +15,146 @@
 
 #define NO_ACTIVE_NODE_FOUND (-1)
 
+// a global relabel is done when the work spent in relabel operations since the last one,
+// multiplied by the frequency, exceeds ALPHA * V + E. Each relabel costs BETA plus the
+// number of arcs scanned.
+#define GLOBAL_RELABEL_ALPHA 6
+#define GLOBAL_RELABEL_BETA 12
+#define DEFAULT_GLOBAL_RELABEL_FREQUENCY 0.5
+
+template <typename Capacity>
 struct Vertex {
 
     int label;
-    int excess;
+    Capacity excess;
 
-    Vertex(int label, int excess) {
+    Vertex(int label, Capacity excess) {
         this->label = label;
         this->excess = excess;
     }
 
 };
 
+template <typename Capacity>
+struct CutArc {
+
+    int u;
+    int v;
+    Capacity capacity;
+
+    CutArc(int u, int v, Capacity capacity) {
+        this->u = u;
+        this->v = v;
+        this->capacity = capacity;
+    }
+
+};
+
+template <typename Capacity>
+struct MinimumCut {
+
+    Capacity value;
+
+    // vertices on the same side of the source
+    std::vector<int> source_side;
+
+    // arcs going from the source side to the sink side, all of them are saturated
+    std::vector<CutArc<Capacity>> arcs;
+
+};
+
+template <typename Capacity>
 struct Edge {
 
-    int flow;
-    int capacity;
+    int u;
+    int v;
+    Capacity capacity;
 
-    Edge(int flow, int capacity) {
-        this->flow = flow;
+    Edge(int u, int v, Capacity capacity) {
+        this->u = u;
+        this->v = v;
         this->capacity = capacity;
     }
 
 };
 
+template <typename Capacity>
+class GraphFile;
+
+template <typename Capacity>
+class DimacsReader;
+
+template <typename Capacity>
+class GraphBuilder;
+
+template <typename Capacity>
+class SolverSelector;
+
+template <typename Capacity>
+class GraphReducer;
+
+template <typename Capacity>
+class VertexOrder;
+
+template <typename Capacity>
 class BaseGraph {
 
+    // graph files read and write the residual graph directly, the other helpers inspect it
+    friend class GraphFile<Capacity>;
+    friend class DimacsReader<Capacity>;
+    friend class GraphBuilder<Capacity>;
+    friend class SolverSelector<Capacity>;
+    friend class GraphReducer<Capacity>;
+    friend class VertexOrder<Capacity>;
+
 protected:
 
-    std::vector<Vertex> vertices;
+    std::vector<Vertex<Capacity>> vertices;
+
+    // edges received through addEdge and not yet turned into residual arcs
+    std::vector<Edge<Capacity>> edges;
 
-    Edge*** edge_matrix;
+    // residual graph in forward-star (CSR) layout: the arcs leaving vertex u are stored
+    // in the range [first_arc[u], first_arc[u + 1]) and every arc knows its reverse arc.
+    std::vector<int> first_arc;
+    std::vector<int> arc_head;
+    std::vector<Capacity> arc_capacity;
+    std::vector<Capacity> arc_residual;
+    std::vector<int> arc_reverse;
+
+    bool arcs_built;
+
+    // arc of each vertex where the search for an admissible arc resumes
+    std::vector<int> current_arc;
 
     bool verbose;
 
-    virtual void printCurrentStatus();
+    // number of threads used by the parallel variations of the graph
+    int threads_count;
+
+    // source and sink vertices of the current run
+    int source;
+    int sink;
+
+    bool global_relabel;
+    double global_relabel_frequency;
+
+    bool gap_heuristic;
 
-    virtual void preProcess(int s, int t);
+    // the preflow and the labels of the last run can be reused after capacity updates
+    bool solved;
 
-    virtual int getActiveNode(int s, int t);
+    void buildArcs();
 
-    virtual bool pushFlow(int u);
+    virtual void setArcCapacity(int arc, Capacity capacity);
 
-    virtual bool relabel(int u);
+    virtual void repairArc(int arc);
+
+    static bool isPositive(Capacity value);
+
+    MinimumCut<Capacity> extractMinimumCut();
+
+    virtual void printCurrentStatus();
 
 public:
 
@@ -65,9 +164,33 @@ public:
 
     void setVerbose(bool verbose);
 
-    void addEdge(int u, int v, int capacity);
+    void setGlobalRelabel(bool enabled);
+
+    void setGlobalRelabelFrequency(double frequency);
+
+    void setGapHeuristic(bool enabled);
+
+    void setThreadCount(int threads_count);
+
+    void addEdge(int u, int v, Capacity capacity);
+
+    void updateEdgeCapacity(int u, int v, Capacity capacity);
+
+    void removeEdge(int u, int v);
+
+    void moveTo(BaseGraph<Capacity> &target);
+
+    void copySettings(BaseGraph<Capacity> &target) const;
+
+    virtual Capacity getMaximumFlow(int s, int t) = 0;
+
+    virtual MinimumCut<Capacity> getMinimumCut(int s, int t);
+
+    virtual Capacity resolveMaximumFlow();
+
+    virtual MinimumCut<Capacity> resolveMinimumCut();
 
-    int getMaximumFlow(int s, int t);
+    virtual SolverStatistics getStatistics();
 };
 
 #endif //ADVANCEDALGORITHMSPROJECT_GRAPH_H
\ No newline at end of file
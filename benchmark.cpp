@@ -0,0 +1,286 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include "goldberg_algorthm_solver.h"
+#include "instance_generator.h"
+
+#define DEFAULT_SEED 1
+#define DEFAULT_RUNS 10
+#define DEFAULT_WARMUP 2
+
+struct BenchmarkOptions {
+
+    std::vector<std::string> families;
+    std::vector<int> sizes;
+    std::vector<int> solvers;
+    std::vector<VertexOrdering> orders;
+    uint64_t seed;
+    int runs;
+    int warmup;
+    int threads;
+    bool global_relabel;
+    bool gap_heuristic;
+    std::string format;
+
+};
+
+/**
+ * Timings of one solver on one instance, all the times are in nanoseconds.
+ */
+struct Measurement {
+
+    std::string family;
+    int size;
+    int vertices_count;
+    long edges_count;
+    std::string solver;
+    std::string order;
+    std::string flow;
+    int runs;
+    long long min_time;
+    long long p50_time;
+    long long p90_time;
+    long long p99_time;
+    long long max_time;
+    long long mean_time;
+
+};
+
+static const char* SOLVER_NAMES[] = {"generic", "lift_to_front", "highest_label", "parallel", "fifo", "dense", "boykov_kolmogorov", "dinic", "excess_scaling", "auto"};
+
+static const char* ORDER_NAMES[] = {"original", "bfs", "rcm"};
+
+static std::vector<std::string> split(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * Nearest-rank percentile of a sorted list of times.
+ * @param sorted the times, in increasing order.
+ * @param percentile between 0 and 100.
+ */
+static long long percentile(const std::vector<long long> &sorted, int percentile) {
+    auto rank = (size_t) ((percentile * sorted.size() + 99) / 100);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+template <typename Capacity>
+static Measurement measure(const Instance<Capacity> &instance, int size, int solver, VertexOrdering ordering, const BenchmarkOptions &options) {
+    GoldbergProblemSolver<Capacity> problem(instance.vertices_count, (SolverType) solver, false);
+    problem.setVertexOrdering(ordering);
+    problem.setGlobalRelabel(options.global_relabel);
+    problem.setGapHeuristic(options.gap_heuristic);
+    if (options.threads > 0) {
+        problem.setThreadCount(options.threads);
+    }
+    GraphBuilder<Capacity> builder(instance.vertices_count);
+    builder.addEdges(instance.edges.begin(), instance.edges.end());
+    problem.loadGraphBuilder(builder);
+    // the first runs also build the residual graph, reorder it and warm up the caches, they are not measured
+    Capacity flow = 0;
+    for (int i = 0; i < options.warmup; i++) {
+        flow = problem.getMaximumFlow(instance.source, instance.sink);
+    }
+    std::vector<long long> times;
+    for (int i = 0; i < options.runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        flow = problem.getMaximumFlow(instance.source, instance.sink);
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    long long total = 0;
+    for (long long time : times) {
+        total += time;
+    }
+    Measurement measurement;
+    measurement.family = instance.family;
+    measurement.size = size;
+    measurement.vertices_count = instance.vertices_count;
+    measurement.edges_count = (long) instance.edges.size();
+    measurement.solver = SOLVER_NAMES[solver];
+    if (solver == AUTO_SOLVER) {
+        // report the variation chosen for the instance too
+        measurement.solver += std::string(":") + SOLVER_NAMES[problem.getSolverType()];
+    }
+    measurement.order = ORDER_NAMES[ordering];
+    std::ostringstream value;
+    value << flow;
+    measurement.flow = value.str();
+    measurement.runs = options.runs;
+    measurement.min_time = times.front();
+    measurement.p50_time = percentile(times, 50);
+    measurement.p90_time = percentile(times, 90);
+    measurement.p99_time = percentile(times, 99);
+    measurement.max_time = times.back();
+    measurement.mean_time = total / (long long) times.size();
+    return measurement;
+}
+
+template <typename Capacity>
+static std::vector<Measurement> runBenchmark(const BenchmarkOptions &options) {
+    std::vector<Measurement> measurements;
+    for (auto &family : options.families) {
+        for (int size : options.sizes) {
+            // every solver is measured on the same instance
+            InstanceGenerator<Capacity> generator(options.seed);
+            Instance<Capacity> instance = generator.generate(family, size);
+            for (int solver : options.solvers) {
+                for (VertexOrdering ordering : options.orders) {
+                    measurements.push_back(measure(instance, size, solver, ordering, options));
+                    auto &last = measurements.back();
+                    std::cerr << last.family << " " << last.size << " " << last.solver << " " << last.order << ": flow " << last.flow << ", median " << last.p50_time << " ns" << std::endl;
+                }
+            }
+        }
+    }
+    return measurements;
+}
+
+static void writeCsv(std::ostream &output, const std::vector<Measurement> &measurements) {
+    output << "family,size,vertices,edges,solver,order,flow,runs,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns" << std::endl;
+    for (auto &m : measurements) {
+        output << m.family << "," << m.size << "," << m.vertices_count << "," << m.edges_count << "," << m.solver << "," << m.order << "," << m.flow << "," << m.runs << "," << m.min_time << "," << m.p50_time << "," << m.p90_time << "," << m.p99_time << "," << m.max_time << "," << m.mean_time << std::endl;
+    }
+}
+
+static void writeJson(std::ostream &output, const std::vector<Measurement> &measurements) {
+    output << "[" << std::endl;
+    for (size_t i = 0; i < measurements.size(); i++) {
+        auto &m = measurements[i];
+        output << "  {\"family\": \"" << m.family << "\", \"size\": " << m.size << ", \"vertices\": " << m.vertices_count << ", \"edges\": " << m.edges_count << ", \"solver\": \"" << m.solver << "\", \"order\": \"" << m.order << "\", \"flow\": " << m.flow << ", \"runs\": " << m.runs << ", \"min_ns\": " << m.min_time << ", \"p50_ns\": " << m.p50_time << ", \"p90_ns\": " << m.p90_time << ", \"p99_ns\": " << m.p99_time << ", \"max_ns\": " << m.max_time << ", \"mean_ns\": " << m.mean_time << "}";
+        output << (i + 1 < measurements.size() ? "," : "") << std::endl;
+    }
+    output << "]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const char* usage = "Usage: benchmark [--family all | grid | ak | genrmf | random | bipartite (comma separated)] [--sizes 1000,10000] [-m 0,1,2,3,4,5,6,7,8,auto] [--order original,bfs,rcm] [--seed n] [--runs n] [--warmup n] [-p threads] [-g to enable global relabel] [--gap to enable gap heuristic] [--capacity int32 | int64 | double] [--format csv | json] [-o output file]";
+    BenchmarkOptions options;
+    options.families = InstanceGenerator<int32_t>::getFamilies();
+    options.sizes = {1000, 10000};
+    options.solvers = {0, 1, 2, 3, 4};
+    options.orders = {ORIGINAL_ORDER};
+    options.seed = DEFAULT_SEED;
+    options.runs = DEFAULT_RUNS;
+    options.warmup = DEFAULT_WARMUP;
+    options.threads = 0;
+    options.global_relabel = false;
+    options.gap_heuristic = false;
+    options.format = "csv";
+    std::string capacity_type = "int32";
+    char* output_file = nullptr;
+    // parse those parameters from the cli command line
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--family") == 0 && i + 1 < argc) {
+            std::string families = argv[++i];
+            options.families = families == "all" ? InstanceGenerator<int32_t>::getFamilies() : split(families);
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            options.sizes.clear();
+            for (auto &size : split(argv[++i])) {
+                options.sizes.push_back(std::stoi(size));
+            }
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            options.solvers.clear();
+            for (auto &solver : split(argv[++i])) {
+                options.solvers.push_back(solver == "auto" ? AUTO_SOLVER : std::stoi(solver));
+            }
+        } else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            options.orders.clear();
+            for (auto &order : split(argv[++i])) {
+                auto name = std::find_if(std::begin(ORDER_NAMES), std::end(ORDER_NAMES), [&order](const char* name) {
+                    return order == name;
+                });
+                if (name == std::end(ORDER_NAMES)) {
+                    std::cerr << "Unknown vertex order " << order << ". " << usage << std::endl;
+                    return 1;
+                }
+                options.orders.push_back((VertexOrdering) (name - std::begin(ORDER_NAMES)));
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = std::stoull(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            options.runs = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            options.warmup = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            options.threads = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0) {
+            options.global_relabel = true;
+        } else if (strcmp(argv[i], "--gap") == 0) {
+            options.gap_heuristic = true;
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity_type = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            options.format = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else {
+            std::cerr << "Unknown argument " << argv[i] << ". " << usage << std::endl;
+            return 1;
+        }
+    }
+    // validate the parameters
+    for (auto &family : options.families) {
+        if (!InstanceGenerator<int32_t>::isFamily(family)) {
+            std::cerr << "Unknown family " << family << ". " << usage << std::endl;
+            return 1;
+        }
+    }
+    for (int solver : options.solvers) {
+        if (solver < GENERIC_SOLVER || solver > AUTO_SOLVER) {
+            std::cerr << "Invalid solver mode " << solver << ". " << usage << std::endl;
+            return 1;
+        }
+    }
+    if (options.runs <= 0 || options.warmup < 0 || options.sizes.empty() || options.orders.empty()) {
+        std::cerr << "At least one size, one order and one run are needed. " << usage << std::endl;
+        return 1;
+    }
+    if (options.format != "csv" && options.format != "json") {
+        std::cerr << "Invalid output format. " << usage << std::endl;
+        return 1;
+    }
+    std::vector<Measurement> measurements;
+    if (capacity_type == "int64") {
+        measurements = runBenchmark<int64_t>(options);
+    } else if (capacity_type == "double") {
+        measurements = runBenchmark<double>(options);
+    } else if (capacity_type == "int32") {
+        measurements = runBenchmark<int32_t>(options);
+    } else {
+        std::cerr << "Invalid capacity type. " << usage << std::endl;
+        return 1;
+    }
+    // write the results on the output file or on the standard output
+    std::ofstream file;
+    if (output_file != nullptr) {
+        file.open(output_file);
+        if (!file) {
+            std::cerr << "Unable to create the output file " << output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &output = output_file != nullptr ? file : std::cout;
+    if (options.format == "json") {
+        writeJson(output, measurements);
+    } else {
+        writeCsv(output, measurements);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include "boykov_kolmogorov_graph.h"
+
+#define FREE 0
+#define SOURCE_TREE 1
+#define SINK_TREE 2
+
+// parent markers of the roots, of the orphans and of the free vertices
+#define TERMINAL (-1)
+#define ORPHAN (-2)
+#define NO_PARENT (-3)
+
+template <typename Capacity, typename Statistics>
+BoykovKolmogorovGraph<Capacity, Statistics>::BoykovKolmogorovGraph(int vertices_count) : BaseGraph<Capacity>(vertices_count) {
+    this->time = 0;
+    this->active_head = 0;
+    this->active_size = 0;
+}
+
+template <typename Capacity, typename Statistics>
+void BoykovKolmogorovGraph<Capacity, Statistics>::activate(int v) {
+    if (!this->is_active[v]) {
+        auto capacity = (int) this->active.size();
+        this->active[(this->active_head + this->active_size) % capacity] = v;
+        this->active_size += 1;
+        this->is_active[v] = true;
+    }
+}
+
+/**
+ * Arcs are always scanned from the vertex of the tree: the ones of the source tree carry flow
+ * away from it, the ones of the sink tree carry flow towards it through the reverse arc.
+ * @param v vertex of a tree.
+ * @param arc arc leaving v.
+ * @return true if the arc, or its reverse in the sink tree, can carry flow away from the root.
+ */
+template <typename Capacity, typename Statistics>
+bool BoykovKolmogorovGraph<Capacity, Statistics>::hasResidual(int v, int arc) const {
+    if (this->tree[v] == SOURCE_TREE) {
+        return this->isPositive(this->arc_residual[arc]);
+    }
+    return this->isPositive(this->arc_residual[this->arc_reverse[arc]]);
+}
+
+/**
+ * Extend the tree of p with its free neighbors. A neighbor of the same tree closer to the root
+ * through p is moved under it, which keeps the paths short after many adoptions.
+ * @param p an active vertex.
+ * @return the arc going from the source tree to the sink tree if the trees touch, -1 otherwise.
+ */
+template <typename Capacity, typename Statistics>
+int BoykovKolmogorovGraph<Capacity, Statistics>::grow(int p) {
+    int begin = this->first_arc[p];
+    int end = this->first_arc[p + 1];
+    for (int arc = begin; arc < end; arc++) {
+        if (!hasResidual(p, arc)) {
+            continue;
+        }
+        int q = this->arc_head[arc];
+        if (this->tree[q] == FREE) {
+            this->tree[q] = this->tree[p];
+            this->parent[q] = this->arc_reverse[arc];
+            this->timestamp[q] = this->timestamp[p];
+            this->distance[q] = this->distance[p] + 1;
+            activate(q);
+        } else if (this->tree[q] != this->tree[p]) {
+            this->statistics.countArcScans(arc - begin + 1);
+            return this->tree[p] == SOURCE_TREE ? arc : this->arc_reverse[arc];
+        } else if (this->parent[q] >= 0 && this->timestamp[q] <= this->timestamp[p] && this->distance[q] > this->distance[p]) {
+            this->parent[q] = this->arc_reverse[arc];
+            this->timestamp[q] = this->timestamp[p];
+            this->distance[q] = this->distance[p] + 1;
+        }
+    }
+    this->statistics.countArcScans(end - begin);
+    return -1;
+}
+
+/**
+ * Push the bottleneck of the path through the given arc. The vertices whose parent arc is
+ * saturated become orphans, the rest of both trees is kept for the next searches.
+ * @param meeting_arc arc from a vertex of the source tree to a vertex of the sink tree.
+ * @return the flow pushed.
+ */
+template <typename Capacity, typename Statistics>
+Capacity BoykovKolmogorovGraph<Capacity, Statistics>::augment(int meeting_arc) {
+    int x = this->arc_head[this->arc_reverse[meeting_arc]];
+    int y = this->arc_head[meeting_arc];
+    // the parent arcs point to the root, so the source side uses their reverse
+    Capacity flow = this->arc_residual[meeting_arc];
+    for (int v = x; this->parent[v] != TERMINAL; v = this->arc_head[this->parent[v]]) {
+        flow = std::min(flow, this->arc_residual[this->arc_reverse[this->parent[v]]]);
+    }
+    for (int v = y; this->parent[v] != TERMINAL; v = this->arc_head[this->parent[v]]) {
+        flow = std::min(flow, this->arc_residual[this->parent[v]]);
+    }
+    this->arc_residual[meeting_arc] -= flow;
+    this->arc_residual[this->arc_reverse[meeting_arc]] += flow;
+    for (int v = x; this->parent[v] != TERMINAL;) {
+        int arc = this->arc_reverse[this->parent[v]];
+        int next = this->arc_head[this->parent[v]];
+        this->arc_residual[arc] -= flow;
+        this->arc_residual[this->parent[v]] += flow;
+        if (!this->isPositive(this->arc_residual[arc])) {
+            this->parent[v] = ORPHAN;
+            this->orphans.push_back(v);
+        }
+        v = next;
+    }
+    for (int v = y; this->parent[v] != TERMINAL;) {
+        int arc = this->parent[v];
+        int next = this->arc_head[arc];
+        this->arc_residual[arc] -= flow;
+        this->arc_residual[this->arc_reverse[arc]] += flow;
+        if (!this->isPositive(this->arc_residual[arc])) {
+            this->parent[v] = ORPHAN;
+            this->orphans.push_back(v);
+        }
+        v = next;
+    }
+    this->statistics.countPush(true);
+    return flow;
+}
+
+/**
+ * Look for a new parent of the orphan among its neighbors of the same tree that are still
+ * connected to the root, choosing the closest one. The distances found while walking to the
+ * root are stamped with the current time, so each vertex is walked at most once per adoption
+ * phase. If there is no such neighbor the orphan becomes free and its children become orphans.
+ * @param p an orphan.
+ */
+template <typename Capacity, typename Statistics>
+void BoykovKolmogorovGraph<Capacity, Statistics>::adopt(int p) {
+    int begin = this->first_arc[p];
+    int end = this->first_arc[p + 1];
+    int best_arc = NO_PARENT;
+    int best_distance = INT_MAX;
+    for (int arc = begin; arc < end; arc++) {
+        int q = this->arc_head[arc];
+        // the parent arc leaves p, so it must be able to carry flow from q in the source tree
+        if (this->tree[q] != this->tree[p] || !hasResidual(q, this->arc_reverse[arc])) {
+            continue;
+        }
+        int d = 0;
+        int j = q;
+        while (true) {
+            if (this->timestamp[j] == this->time) {
+                d += this->distance[j];
+                break;
+            }
+            if (this->parent[j] == TERMINAL) {
+                this->timestamp[j] = this->time;
+                this->distance[j] = 0;
+                break;
+            }
+            if (this->parent[j] == ORPHAN) {
+                d = INT_MAX;
+                break;
+            }
+            d += 1;
+            j = this->arc_head[this->parent[j]];
+        }
+        if (d == INT_MAX) {
+            continue;
+        }
+        if (d < best_distance) {
+            best_arc = arc;
+            best_distance = d;
+        }
+        for (j = q; this->timestamp[j] != this->time; j = this->arc_head[this->parent[j]]) {
+            this->timestamp[j] = this->time;
+            this->distance[j] = d;
+            d -= 1;
+        }
+    }
+    this->statistics.countArcScans(end - begin);
+    this->statistics.countRelabel();
+    if (best_arc != NO_PARENT) {
+        this->parent[p] = best_arc;
+        this->timestamp[p] = this->time;
+        this->distance[p] = best_distance + 1;
+        return;
+    }
+    for (int arc = begin; arc < end; arc++) {
+        int q = this->arc_head[arc];
+        if (this->tree[q] != this->tree[p]) {
+            continue;
+        }
+        // the neighbors that could grow into p again have to be scanned
+        if (hasResidual(q, this->arc_reverse[arc])) {
+            activate(q);
+        }
+        if (this->parent[q] >= 0 && this->arc_head[this->parent[q]] == p) {
+            this->parent[q] = ORPHAN;
+            this->orphans.push_back(q);
+        }
+    }
+    this->tree[p] = FREE;
+    this->parent[p] = NO_PARENT;
+}
+
+template <typename Capacity, typename Statistics>
+Capacity BoykovKolmogorovGraph<Capacity, Statistics>::getMaximumFlow(int s, int t) {
+    this->statistics.reset();
+    typename Statistics::Timer start = this->statistics.startTimer();
+    auto n = (int) this->vertices.size();
+    this->solved = false;
+    this->source = s;
+    this->sink = t;
+    if (!this->arcs_built) {
+        this->buildArcs();
+    }
+    this->arc_residual = this->arc_capacity;
+    this->tree.assign(n, FREE);
+    this->parent.assign(n, NO_PARENT);
+    this->timestamp.assign(n, 0);
+    this->distance.assign(n, 0);
+    this->time = 0;
+    this->active.assign(n, 0);
+    this->active_head = 0;
+    this->active_size = 0;
+    this->is_active.assign(n, false);
+    this->orphans.clear();
+    for (int i = 0; i < n; i++) {
+        this->vertices[i].label = DEFAULT_LABEL;
+        this->vertices[i].excess = DEFAULT_EXCESS;
+    }
+    this->tree[s] = SOURCE_TREE;
+    this->tree[t] = SINK_TREE;
+    this->parent[s] = TERMINAL;
+    this->parent[t] = TERMINAL;
+    activate(s);
+    activate(t);
+    this->statistics.addInitializationTime(start);
+    start = this->statistics.startTimer();
+    Capacity flow = 0;
+    while (this->active_size > 0) {
+        int p = this->active[this->active_head];
+        // the vertex stays at the front of the queue until it has no path left to offer
+        int meeting_arc = this->tree[p] != FREE ? grow(p) : -1;
+        if (meeting_arc < 0) {
+            this->active_head = (this->active_head + 1) % n;
+            this->active_size -= 1;
+            this->is_active[p] = false;
+            this->statistics.countDischarge();
+            continue;
+        }
+        this->time += 1;
+        flow += augment(meeting_arc);
+        for (size_t i = 0; i < this->orphans.size(); i++) {
+            adopt(this->orphans[i]);
+        }
+        this->orphans.clear();
+    }
+    this->statistics.addDischargeTime(start);
+    this->vertices[s].excess = -flow;
+    this->vertices[t].excess = flow;
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Augmenting paths: " << this->statistics.get().saturating_pushes << std::endl;
+        this->printCurrentStatus();
+    }
+    return flow;
+}
+
+template <typename Capacity, typename Statistics>
+SolverStatistics BoykovKolmogorovGraph<Capacity, Statistics>::getStatistics() {
+    return this->statistics.get();
+}
+
+INSTANTIATE_FOR_CAPACITIES_AND_STATISTICS(BoykovKolmogorovGraph)
\ No newline at end of file
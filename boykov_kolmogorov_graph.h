@@ -0,0 +1,61 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_BOYKOV_KOLMOGOROV_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_BOYKOV_KOLMOGOROV_GRAPH_H
+
+#include "base_graph.h"
+#include "solver_statistics.h"
+
+/**
+ * Boykov-Kolmogorov augmenting paths: a search tree grows from the source and another one from the
+ * sink until they touch, the path found is augmented, and the vertices cut off by the saturated
+ * arcs (the orphans) look for a new parent in their tree instead of rebuilding the trees from
+ * scratch. It works on the same residual arcs as the push-relabel graphs, so the minimum cut is
+ * extracted in the same way. In the statistics each augmentation counts as a saturating push,
+ * each adoption attempt as a relabel and each growth of an active vertex as a discharge.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class BoykovKolmogorovGraph final : public BaseGraph<Capacity> {
+
+    // tree of each vertex: FREE, SOURCE_TREE or SINK_TREE
+    std::vector<char> tree;
+
+    // arc leaving the vertex towards its parent, or one of the markers for roots and orphans
+    std::vector<int> parent;
+
+    // distance from the root, valid when the timestamp of the vertex is the current one
+    std::vector<int> timestamp;
+    std::vector<int> distance;
+    int time;
+
+    std::vector<int> active;
+    int active_head;
+    int active_size;
+    std::vector<bool> is_active;
+
+    std::vector<int> orphans;
+
+    Statistics statistics;
+
+    void activate(int v);
+
+    int grow(int p);
+
+    Capacity augment(int meeting_arc);
+
+    void adopt(int p);
+
+    bool hasResidual(int v, int arc) const;
+
+public:
+
+    explicit BoykovKolmogorovGraph(int vertices_count);
+
+    Capacity getMaximumFlow(int s, int t) override;
+
+    SolverStatistics getStatistics() override;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_BOYKOV_KOLMOGOROV_GRAPH_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_CAPACITY_TRAITS_H
+#define ADVANCEDALGORITHMSPROJECT_CAPACITY_TRAITS_H
+
+#include <cstdint>
+
+/**
+ * Comparisons done by the solvers on flows and capacities. Integer capacities are exact, while
+ * floating point ones treat as zero any amount below a small epsilon, so that the rounding errors
+ * left by the pushes cannot keep a vertex active or an arc unsaturated forever.
+ */
+template <typename Capacity>
+struct CapacityTraits {
+
+    static bool isPositive(Capacity value) {
+        return value > 0;
+    }
+
+};
+
+template <>
+struct CapacityTraits<double> {
+
+    static constexpr double epsilon = 1e-9;
+
+    static bool isPositive(double value) {
+        return value > epsilon;
+    }
+
+};
+
+// the graphs and the solver are compiled once for each supported capacity type
+#define INSTANTIATE_FOR_CAPACITIES(name) \
+    template class name<int32_t>; \
+    template class name<int64_t>; \
+    template class name<double>;
+
+#endif //ADVANCEDALGORITHMSPROJECT_CAPACITY_TRAITS_H
\ No newline at end of file
@@ -0,0 +1,279 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <algorithm>
+#include "dense_graph.h"
+#include "dense_kernels.h"
+
+template <typename Capacity, typename Statistics>
+DenseGraph<Capacity, Statistics>::DenseGraph(int vertices_count) : BaseGraph<Capacity>(vertices_count) {
+    this->queue_head = 0;
+    this->queue_size = 0;
+    this->relabel_work = 0;
+}
+
+/**
+ * Fill the residual matrix with the capacities of the arcs, which are built first if needed.
+ * The capacities of parallel arcs are summed in the same element.
+ */
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::buildMatrix() {
+    if (!this->arcs_built) {
+        this->buildArcs();
+    }
+    auto n = (size_t) this->vertices.size();
+    this->residual.assign(n * n, 0);
+    for (size_t u = 0; u < n; u++) {
+        for (int arc = this->first_arc[u]; arc < this->first_arc[u + 1]; arc++) {
+            if (this->arc_head[arc] != u) {
+                this->residual[u * n + this->arc_head[arc]] += this->arc_capacity[arc];
+            }
+        }
+    }
+}
+
+/**
+ * Copy the flow found on the matrix back into the arcs. The net flow between two vertices is
+ * spread over the residual pairs connecting them, each one within the capacities of its arcs.
+ */
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::storeFlow() {
+    auto n = (int) this->vertices.size();
+    std::vector<Capacity> flow(n, 0);
+    for (int u = 0; u < n; u++) {
+        int begin = this->first_arc[u];
+        int end = this->first_arc[u + 1];
+        // net flow from u to each higher neighbor, the lower ones have already been done
+        for (int arc = begin; arc < end; arc++) {
+            flow[this->arc_head[arc]] = -this->residual[(size_t) u * n + this->arc_head[arc]];
+        }
+        for (int arc = begin; arc < end; arc++) {
+            flow[this->arc_head[arc]] += this->arc_capacity[arc];
+        }
+        for (int arc = begin; arc < end; arc++) {
+            int v = this->arc_head[arc];
+            int reverse = this->arc_reverse[arc];
+            if (v == u) {
+                this->arc_residual[arc] = this->arc_capacity[arc];
+            } else if (v > u) {
+                Capacity amount = std::max(-this->arc_capacity[reverse], std::min(flow[v], this->arc_capacity[arc]));
+                this->arc_residual[arc] = this->arc_capacity[arc] - amount;
+                this->arc_residual[reverse] = this->arc_capacity[reverse] + amount;
+                flow[v] -= amount;
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        this->vertices[i].label = this->label[i];
+        this->vertices[i].excess = this->excess[i];
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::enqueue(int v) {
+    auto capacity = (int) this->queue.size();
+    this->queue[(this->queue_head + this->queue_size) % capacity] = v;
+    this->queue_size += 1;
+    this->queued[v] = true;
+}
+
+/**
+ * Exact distances from the sink, and from the source for the vertices that cannot reach it,
+ * as in the sparse graphs. Vertex i reaches w if the element i of column w has some capacity.
+ */
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::globalRelabel() {
+    typename Statistics::Timer start = this->statistics.startTimer();
+    auto n = (int) this->vertices.size();
+    int unreached = 2 * n;
+    std::fill(this->label.begin(), this->label.end(), unreached);
+    std::vector<int> bfs;
+    bfs.reserve(n);
+    int roots[] = {this->sink, this->source};
+    int distances[] = {0, n};
+    for (int r = 0; r < 2; r++) {
+        this->label[roots[r]] = distances[r];
+        bfs.clear();
+        bfs.push_back(roots[r]);
+        for (int head = 0; head < bfs.size(); head++) {
+            int w = bfs[head];
+            for (int i = 0; i < n; i++) {
+                if (this->label[i] == unreached && i != this->source && this->isPositive(this->residual[(size_t) i * n + w])) {
+                    this->label[i] = this->label[w] + 1;
+                    bfs.push_back(i);
+                }
+            }
+        }
+    }
+    this->relabel_work = 0;
+    std::fill(this->current.begin(), this->current.end(), 0);
+    if (this->gap_heuristic) {
+        std::fill(this->label_count.begin(), this->label_count.end(), 0);
+        for (int i = 0; i < n; i++) {
+            if (i != this->source) {
+                this->label_count[this->label[i]] += 1;
+            }
+        }
+    }
+    this->statistics.countGlobalRelabel();
+    this->statistics.addGlobalRelabelTime(start);
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Global relabel done" << std::endl;
+    }
+}
+
+/**
+ * No vertex has the given label anymore, the ones above it (below V) cannot reach the sink.
+ * @param empty the label that has been emptied.
+ */
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::gap(int empty) {
+    auto n = (int) this->vertices.size();
+    for (int i = 0; i < n; i++) {
+        if (i != this->source && this->label[i] > empty && this->label[i] < n) {
+            this->label_count[this->label[i]] -= 1;
+            this->label_count[n + 1] += 1;
+            this->label[i] = n + 1;
+            this->current[i] = 0;
+        }
+    }
+    this->statistics.countGap();
+}
+
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::push(int u, int v) {
+    auto n = (size_t) this->vertices.size();
+    Capacity &forward = this->residual[u * n + v];
+    Capacity flow = std::min(forward, this->excess[u]);
+    forward -= flow;
+    this->residual[v * n + u] += flow;
+    this->excess[u] -= flow;
+    this->excess[v] += flow;
+    if (v != this->source && v != this->sink && !this->queued[v]) {
+        enqueue(v);
+    }
+    this->statistics.countPush(!this->isPositive(forward));
+}
+
+/**
+ * The lowest label among the heads of the residual arcs is found with a single row scan.
+ * @param u index of the vertex to relabel.
+ */
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::relabel(int u) {
+    auto n = (int) this->vertices.size();
+    int previous = this->label[u];
+    int minimum = DenseKernels<Capacity>::minimumLabel(&this->residual[(size_t) u * n], this->label.data(), n);
+    // a vertex with excess can always send it back to the source, the check only keeps the label bounded
+    this->label[u] = minimum == NO_LABEL ? 2 * n : minimum + 1;
+    this->current[u] = 0;
+    this->statistics.countRelabel();
+    this->statistics.countArcScans(n);
+    if (this->gap_heuristic) {
+        this->label_count[previous] -= 1;
+        this->label_count[this->label[u]] += 1;
+        if (this->label_count[previous] == 0 && previous < n) {
+            gap(previous);
+        }
+    }
+}
+
+/**
+ * Push the excess of u through the admissible arcs found from its current position in the row,
+ * relabeling the vertex once if the end of the row is reached.
+ * @param u index of the active vertex.
+ */
+template <typename Capacity, typename Statistics>
+void DenseGraph<Capacity, Statistics>::discharge(int u) {
+    auto n = (int) this->vertices.size();
+    const Capacity* row = &this->residual[(size_t) u * n];
+    this->statistics.countDischarge();
+    while (this->isPositive(this->excess[u])) {
+        int v = DenseKernels<Capacity>::findAdmissible(row, this->label.data(), this->current[u], n, this->label[u] - 1);
+        this->statistics.countArcScans(std::min(v + 1, n) - this->current[u]);
+        if (v == n) {
+            relabel(u);
+            // labels may be too small on large graphs, recompute them once enough work has been done
+            if (this->global_relabel) {
+                this->relabel_work += GLOBAL_RELABEL_BETA + n;
+                if (this->global_relabel_frequency * this->relabel_work > GLOBAL_RELABEL_ALPHA * n + this->arc_head.size() / 2) {
+                    globalRelabel();
+                }
+            }
+            return;
+        }
+        this->current[u] = v;
+        push(u, v);
+    }
+}
+
+template <typename Capacity, typename Statistics>
+Capacity DenseGraph<Capacity, Statistics>::getMaximumFlow(int s, int t) {
+    this->statistics.reset();
+    typename Statistics::Timer start = this->statistics.startTimer();
+    auto n = (int) this->vertices.size();
+    this->solved = false;
+    this->source = s;
+    this->sink = t;
+    buildMatrix();
+    this->label.assign(n, 0);
+    this->label[s] = n;
+    this->excess.assign(n, 0);
+    this->current.assign(n, 0);
+    this->queue.assign(n, 0);
+    this->queue_head = 0;
+    this->queue_size = 0;
+    this->queued.assign(n, false);
+    this->relabel_work = 0;
+    // saturate the arcs leaving the source
+    for (int v = 0; v < n; v++) {
+        Capacity flow = this->residual[(size_t) s * n + v];
+        if (v != s && this->isPositive(flow)) {
+            this->residual[(size_t) s * n + v] = 0;
+            this->residual[(size_t) v * n + s] += flow;
+            this->excess[v] += flow;
+            this->excess[s] -= flow;
+            if (v != t) {
+                enqueue(v);
+            }
+        }
+    }
+    if (this->gap_heuristic) {
+        this->label_count.assign(2 * n + 1, 0);
+        this->label_count[0] = n - 1;
+    }
+    if (this->global_relabel) {
+        globalRelabel();
+    }
+    this->statistics.addInitializationTime(start);
+    start = this->statistics.startTimer();
+    while (this->queue_size > 0) {
+        int u = this->queue[this->queue_head];
+        this->queue_head = (this->queue_head + 1) % n;
+        this->queue_size -= 1;
+        this->queued[u] = false;
+        if (!this->isPositive(this->excess[u]) || this->label[u] >= 2 * n) {
+            continue;
+        }
+        discharge(u);
+        // the vertex goes to the end of the queue if it has been relabeled
+        if (this->isPositive(this->excess[u]) && !this->queued[u]) {
+            enqueue(u);
+        }
+    }
+    this->statistics.addDischargeTime(start);
+    storeFlow();
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Dense kernels: " << DenseKernels<Capacity>::getInstructionSet() << std::endl;
+        this->printCurrentStatus();
+    }
+    return this->excess[t];
+}
+
+template <typename Capacity, typename Statistics>
+SolverStatistics DenseGraph<Capacity, Statistics>::getStatistics() {
+    return this->statistics.get();
+}
+
+INSTANTIATE_FOR_CAPACITIES_AND_STATISTICS(DenseGraph)
\ No newline at end of file
@@ -0,0 +1,67 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_DENSE_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_DENSE_GRAPH_H
+
+#include "base_graph.h"
+#include "solver_statistics.h"
+
+/**
+ * Push-relabel on an adjacency matrix, meant for dense graphs. The residual capacities are kept
+ * in one row-major array of V * V elements and the labels in a separate array, so the search for
+ * an admissible arc and the relabel scan a row of the matrix with the vectorized DenseKernels.
+ * Active vertices are discharged in FIFO order. At the end the flow is copied back into the arcs
+ * of the graph, so the minimum cut is extracted as for the other variations.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class DenseGraph final : public BaseGraph<Capacity> {
+
+    // residual capacity of u->v at u * V + v, the capacities of all the arcs between two vertices are summed
+    std::vector<Capacity> residual;
+
+    std::vector<int> label;
+    std::vector<Capacity> excess;
+
+    // position of each vertex in its row where the search for an admissible arc resumes
+    std::vector<int> current;
+
+    // number of vertices (the source excluded) with each label, used by the gap heuristic
+    std::vector<int> label_count;
+
+    std::vector<int> queue;
+    int queue_head;
+    int queue_size;
+    std::vector<bool> queued;
+
+    long relabel_work;
+
+    Statistics statistics;
+
+    void buildMatrix();
+
+    void storeFlow();
+
+    void enqueue(int v);
+
+    void globalRelabel();
+
+    void gap(int empty);
+
+    void push(int u, int v);
+
+    void relabel(int u);
+
+    void discharge(int u);
+
+public:
+
+    explicit DenseGraph(int vertices_count);
+
+    Capacity getMaximumFlow(int s, int t) override;
+
+    SolverStatistics getStatistics() override;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_DENSE_GRAPH_H
\ No newline at end of file
@@ -0,0 +1,164 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include "dense_kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DENSE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*FindAdmissibleKernel)(const int32_t*, const int*, int, int, int);
+typedef int (*MinimumLabelKernel)(const int32_t*, const int*, int, int);
+
+/**
+ * Kernels used for int32_t capacities, chosen once by the CPU detection.
+ */
+struct KernelSet {
+
+    FindAdmissibleKernel find_admissible;
+    MinimumLabelKernel minimum_label;
+    const char* name;
+
+};
+
+/**
+ * The vectorized versions leave to the scalar ones the last elements of the row,
+ * fewer than a vector.
+ */
+static int findAdmissibleScalar(const int32_t* residual, const int* label, int begin, int end, int target) {
+    for (int v = begin; v < end; v++) {
+        if (residual[v] > 0 && label[v] == target) {
+            return v;
+        }
+    }
+    return end;
+}
+
+static int minimumLabelScalar(const int32_t* residual, const int* label, int begin, int end) {
+    int minimum = NO_LABEL;
+    for (int v = begin; v < end; v++) {
+        if (residual[v] > 0 && label[v] < minimum) {
+            minimum = label[v];
+        }
+    }
+    return minimum;
+}
+
+#ifdef DENSE_KERNELS_X86
+
+/**
+ * Eight arcs at a time: the lanes with residual capacity and the target label are collected
+ * in a bit mask, whose lowest set bit is the first admissible arc.
+ */
+__attribute__((target("avx2")))
+static int findAdmissibleAvx2(const int32_t* residual, const int* label, int begin, int end, int target) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i wanted = _mm256_set1_epi32(target);
+    int v = begin;
+    for (; v + 8 <= end; v += 8) {
+        __m256i capacity = _mm256_loadu_si256((const __m256i*) (residual + v));
+        __m256i labels = _mm256_loadu_si256((const __m256i*) (label + v));
+        __m256i admissible = _mm256_and_si256(_mm256_cmpgt_epi32(capacity, zero), _mm256_cmpeq_epi32(labels, wanted));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(admissible));
+        if (mask != 0) {
+            return v + __builtin_ctz((unsigned) mask);
+        }
+    }
+    return findAdmissibleScalar(residual, label, v, end, target);
+}
+
+/**
+ * The labels of the saturated arcs are replaced with NO_LABEL, then eight running minimums
+ * are kept and reduced at the end.
+ */
+__attribute__((target("avx2")))
+static int minimumLabelAvx2(const int32_t* residual, const int* label, int begin, int end) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i none = _mm256_set1_epi32(NO_LABEL);
+    __m256i minimum = none;
+    int v = begin;
+    for (; v + 8 <= end; v += 8) {
+        __m256i capacity = _mm256_loadu_si256((const __m256i*) (residual + v));
+        __m256i labels = _mm256_loadu_si256((const __m256i*) (label + v));
+        __m256i candidate = _mm256_blendv_epi8(none, labels, _mm256_cmpgt_epi32(capacity, zero));
+        minimum = _mm256_min_epi32(minimum, candidate);
+    }
+    __m128i half = _mm_min_epi32(_mm256_castsi256_si128(minimum), _mm256_extracti128_si256(minimum, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(half);
+    int rest = minimumLabelScalar(residual, label, v, end);
+    return rest < result ? rest : result;
+}
+
+__attribute__((target("sse4.1")))
+static int findAdmissibleSse(const int32_t* residual, const int* label, int begin, int end, int target) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wanted = _mm_set1_epi32(target);
+    int v = begin;
+    for (; v + 4 <= end; v += 4) {
+        __m128i capacity = _mm_loadu_si128((const __m128i*) (residual + v));
+        __m128i labels = _mm_loadu_si128((const __m128i*) (label + v));
+        __m128i admissible = _mm_and_si128(_mm_cmpgt_epi32(capacity, zero), _mm_cmpeq_epi32(labels, wanted));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(admissible));
+        if (mask != 0) {
+            return v + __builtin_ctz((unsigned) mask);
+        }
+    }
+    return findAdmissibleScalar(residual, label, v, end, target);
+}
+
+__attribute__((target("sse4.1")))
+static int minimumLabelSse(const int32_t* residual, const int* label, int begin, int end) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i none = _mm_set1_epi32(NO_LABEL);
+    __m128i minimum = none;
+    int v = begin;
+    for (; v + 4 <= end; v += 4) {
+        __m128i capacity = _mm_loadu_si128((const __m128i*) (residual + v));
+        __m128i labels = _mm_loadu_si128((const __m128i*) (label + v));
+        __m128i candidate = _mm_blendv_epi8(none, labels, _mm_cmpgt_epi32(capacity, zero));
+        minimum = _mm_min_epi32(minimum, candidate);
+    }
+    minimum = _mm_min_epi32(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+    minimum = _mm_min_epi32(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(minimum);
+    int rest = minimumLabelScalar(residual, label, v, end);
+    return rest < result ? rest : result;
+}
+
+#endif
+
+/**
+ * Pick the kernels once, the first time they are needed.
+ */
+static KernelSet detectKernels() {
+#ifdef DENSE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return KernelSet {findAdmissibleAvx2, minimumLabelAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return KernelSet {findAdmissibleSse, minimumLabelSse, "sse4.1"};
+    }
+#endif
+    return KernelSet {findAdmissibleScalar, minimumLabelScalar, "scalar"};
+}
+
+static const KernelSet &getKernels() {
+    static const KernelSet kernels = detectKernels();
+    return kernels;
+}
+
+int DenseKernels<int32_t>::findAdmissible(const int32_t* residual, const int* label, int begin, int end, int target) {
+    return getKernels().find_admissible(residual, label, begin, end, target);
+}
+
+int DenseKernels<int32_t>::minimumLabel(const int32_t* residual, const int* label, int end) {
+    return getKernels().minimum_label(residual, label, 0, end);
+}
+
+const char* DenseKernels<int32_t>::getInstructionSet() {
+    return getKernels().name;
+}
\ No newline at end of file
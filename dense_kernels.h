@@ -0,0 +1,73 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_DENSE_KERNELS_H
+#define ADVANCEDALGORITHMSPROJECT_DENSE_KERNELS_H
+
+#include <climits>
+#include "capacity_traits.h"
+
+#define NO_LABEL INT_MAX
+
+/**
+ * Scans of a row of the residual matrix used by the dense graph. The residual capacities of the
+ * row and the labels of the vertices are two separate arrays indexed by the head vertex, so the
+ * scans can compare several arcs at once. The generic version is scalar; the one for int32_t
+ * capacities picks at runtime the widest instruction set supported by the CPU.
+ */
+template <typename Capacity>
+struct DenseKernels {
+
+    /**
+     * @param residual row of the residual matrix.
+     * @param label labels of the vertices.
+     * @param begin first head to check.
+     * @param end size of the row.
+     * @param target label of the heads of the admissible arcs.
+     * @return the first head in [begin, end) of an arc with residual capacity and the target
+     *         label, or end if there is none.
+     */
+    static int findAdmissible(const Capacity* residual, const int* label, int begin, int end, int target) {
+        for (int v = begin; v < end; v++) {
+            if (CapacityTraits<Capacity>::isPositive(residual[v]) && label[v] == target) {
+                return v;
+            }
+        }
+        return end;
+    }
+
+    /**
+     * @param residual row of the residual matrix.
+     * @param label labels of the vertices.
+     * @param end size of the row.
+     * @return the lowest label among the heads of the arcs with residual capacity, or NO_LABEL.
+     */
+    static int minimumLabel(const Capacity* residual, const int* label, int end) {
+        int minimum = NO_LABEL;
+        for (int v = 0; v < end; v++) {
+            if (CapacityTraits<Capacity>::isPositive(residual[v]) && label[v] < minimum) {
+                minimum = label[v];
+            }
+        }
+        return minimum;
+    }
+
+    static const char* getInstructionSet() {
+        return "scalar";
+    }
+
+};
+
+template <>
+struct DenseKernels<int32_t> {
+
+    static int findAdmissible(const int32_t* residual, const int* label, int begin, int end, int target);
+
+    static int minimumLabel(const int32_t* residual, const int* label, int end);
+
+    static const char* getInstructionSet();
+
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_DENSE_KERNELS_H
\ No newline at end of file
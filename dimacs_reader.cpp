@@ -0,0 +1,416 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <fstream>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dimacs_reader.h"
+
+// shortest possible arc line, "a 1 2 0" and its terminator: no file holds more arcs than its
+// size over this, whatever its problem line says
+#define MIN_ARC_LINE_LENGTH 8
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * Find the boundaries of the next token of a line.
+ * @param cursor moved after the token.
+ * @param end end of the line.
+ * @param token set to the first character of the token.
+ * @return the length of the token, 0 if the line has no more tokens.
+ */
+static size_t nextToken(const char* &cursor, const char* end, const char* &token) {
+    while (cursor < end && isBlank(*cursor)) {
+        cursor++;
+    }
+    token = cursor;
+    while (cursor < end && !isBlank(*cursor)) {
+        cursor++;
+    }
+    return (size_t) (cursor - token);
+}
+
+/**
+ * Parse a signed decimal integer, the tokens that do not fit in a long long are rejected.
+ */
+static bool parseInteger(const char* &cursor, const char* end, long long &value) {
+    const char* token;
+    size_t length = nextToken(cursor, end, token);
+    if (length == 0) {
+        return false;
+    }
+    bool negative = token[0] == '-';
+    size_t i = negative ? 1 : 0;
+    if (i == length) {
+        return false;
+    }
+    // the digits are accumulated as a magnitude, LLONG_MIN has one more than LLONG_MAX
+    unsigned long long limit = negative ? (unsigned long long) LLONG_MAX + 1 : (unsigned long long) LLONG_MAX;
+    unsigned long long magnitude = 0;
+    for (; i < length; i++) {
+        if (token[i] < '0' || token[i] > '9') {
+            return false;
+        }
+        auto digit = (unsigned long long) (token[i] - '0');
+        if (magnitude > (limit - digit) / 10) {
+            return false;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    value = negative ? (long long) (0 - magnitude) : (long long) magnitude;
+    return true;
+}
+
+/**
+ * Integer capacities are parsed exactly, floating point ones go through strtod on a copy
+ * of the token since the mapped file is not terminated by a null character.
+ */
+static bool parseCapacity(const char* &cursor, const char* end, int32_t &value) {
+    long long parsed;
+    if (!parseInteger(cursor, end, parsed) || parsed < INT32_MIN || parsed > INT32_MAX) {
+        return false;
+    }
+    value = (int32_t) parsed;
+    return true;
+}
+
+static bool parseCapacity(const char* &cursor, const char* end, int64_t &value) {
+    long long parsed;
+    if (!parseInteger(cursor, end, parsed)) {
+        return false;
+    }
+    value = (int64_t) parsed;
+    return true;
+}
+
+static bool parseCapacity(const char* &cursor, const char* end, double &value) {
+    const char* token;
+    size_t length = nextToken(cursor, end, token);
+    char buffer[64];
+    if (length == 0 || length >= sizeof(buffer)) {
+        return false;
+    }
+    memcpy(buffer, token, length);
+    buffer[length] = '\0';
+    char* stop;
+    value = strtod(buffer, &stop);
+    return stop == buffer + length;
+}
+
+static const char* lineEnd(const char* cursor, const char* end) {
+    auto found = static_cast<const char*>(memchr(cursor, '\n', (size_t) (end - cursor)));
+    return found != nullptr ? found : end;
+}
+
+static bool isEmptyLine(const char* cursor, const char* end) {
+    const char* token;
+    return nextToken(cursor, end, token) == 0;
+}
+
+template <typename Capacity>
+DimacsReader<Capacity>::DimacsReader(int threads_count) {
+    if (threads_count <= 0) {
+        threads_count = std::max(1, (int) std::thread::hardware_concurrency());
+    }
+    this->pool.reset(new ThreadPool(threads_count));
+    this->vertices_count = 0;
+    this->arcs_count = 0;
+    this->source = -1;
+    this->sink = -1;
+}
+
+template <typename Capacity>
+DimacsReader<Capacity>::~DimacsReader() = default;
+
+/**
+ * Parse the lines before the first arc: comments, the problem line and the terminal vertices.
+ * @param cursor moved to the beginning of the first arc line.
+ * @param end end of the file.
+ * @param error set to the reason of the failure.
+ * @return true if the problem line has been found and all the lines are valid.
+ */
+template <typename Capacity>
+bool DimacsReader<Capacity>::parseHeader(const char* &cursor, const char* end, std::string &error) {
+    bool problem = false;
+    while (cursor < end) {
+        const char* last = lineEnd(cursor, end);
+        const char* line = cursor;
+        const char* token;
+        size_t length = nextToken(line, last, token);
+        if (length == 1 && token[0] == 'a') {
+            break;
+        }
+        if (length == 1 && token[0] == 'p') {
+            long long vertices, arcs;
+            size_t kind = nextToken(line, last, token);
+            if (problem || kind != 3 || strncmp(token, "max", 3) != 0 || !parseInteger(line, last, vertices) || !parseInteger(line, last, arcs) || vertices <= 0 || vertices > INT_MAX || arcs < 0) {
+                error = "invalid problem line: " + std::string(cursor, last);
+                return false;
+            }
+            this->vertices_count = (int) vertices;
+            this->arcs_count = arcs;
+            problem = true;
+        } else if (length == 1 && token[0] == 'n') {
+            long long vertex;
+            if (!problem || !parseInteger(line, last, vertex) || vertex < 1 || vertex > this->vertices_count || nextToken(line, last, token) != 1 || (token[0] != 's' && token[0] != 't')) {
+                error = "invalid node line: " + std::string(cursor, last);
+                return false;
+            }
+            if (token[0] == 's') {
+                this->source = (int) vertex - 1;
+            } else {
+                this->sink = (int) vertex - 1;
+            }
+        } else if (length != 0 && token[0] != 'c') {
+            error = "unexpected line: " + std::string(cursor, last);
+            return false;
+        }
+        cursor = last < end ? last + 1 : end;
+    }
+    if (!problem) {
+        error = "missing problem line";
+        return false;
+    }
+    return true;
+}
+
+template <typename Capacity>
+bool DimacsReader<Capacity>::parseArc(const char* cursor, const char* end, Edge<Capacity> &edge) const {
+    const char* token;
+    long long u, v;
+    if (nextToken(cursor, end, token) != 1 || token[0] != 'a') {
+        return false;
+    }
+    if (!parseInteger(cursor, end, u) || !parseInteger(cursor, end, v) || !parseCapacity(cursor, end, edge.capacity)) {
+        return false;
+    }
+    if (u < 1 || u > this->vertices_count || v < 1 || v > this->vertices_count || edge.capacity < 0) {
+        return false;
+    }
+    edge.u = (int) u - 1;
+    edge.v = (int) v - 1;
+    return isEmptyLine(cursor, end);
+}
+
+/**
+ * Parse the arc lines of one chunk of the file, comments and empty lines are skipped.
+ * @param thread_id index of the thread, the arcs are stored in its own list.
+ * @param cursor first character of the chunk, at the beginning of a line.
+ * @param end end of the chunk, right after a line terminator or at the end of the file.
+ */
+template <typename Capacity>
+void DimacsReader<Capacity>::parseChunk(int thread_id, const char* cursor, const char* end) {
+    auto &edges = this->thread_edges[thread_id];
+    Edge<Capacity> edge(0, 0, 0);
+    while (cursor < end) {
+        const char* last = lineEnd(cursor, end);
+        const char* line = cursor;
+        const char* token;
+        size_t length = nextToken(line, last, token);
+        if (length == 1 && token[0] == 'a' && parseArc(cursor, last, edge)) {
+            edges.push_back(edge);
+        } else if (length != 0 && token[0] != 'c') {
+            this->thread_error[thread_id] = "invalid arc line: " + std::string(cursor, last);
+            return;
+        }
+        cursor = last < end ? last + 1 : end;
+    }
+}
+
+/**
+ * Map a DIMACS file in memory and parse it, the arc lines are parsed by all the threads.
+ * @param file path of the DIMACS file.
+ * @return true if the file is valid, false otherwise.
+ */
+template <typename Capacity>
+bool DimacsReader<Capacity>::read(const char* file) {
+    int descriptor = open(file, O_RDONLY);
+    if (descriptor < 0) {
+        std::cerr << "Unable to open the DIMACS file " << file << std::endl;
+        return false;
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0) {
+        std::cerr << "Unable to read the DIMACS file " << file << std::endl;
+        close(descriptor);
+        return false;
+    }
+    auto size = (size_t) status.st_size;
+    void* data = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0) : nullptr;
+    close(descriptor);
+    if (data == MAP_FAILED) {
+        std::cerr << "Unable to map the DIMACS file " << file << std::endl;
+        return false;
+    }
+    if (data != nullptr) {
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+    const char* cursor = static_cast<const char*>(data);
+    const char* end = cursor + size;
+    std::string error;
+    bool valid = parseHeader(cursor, end, error);
+    if (valid) {
+        // split the arc lines in one chunk for each thread, each chunk ends after a line terminator
+        int threads_count = this->pool->size();
+        std::vector<const char*> boundary(threads_count + 1, end);
+        boundary[0] = cursor;
+        for (int i = 1; i < threads_count; i++) {
+            const char* middle = std::max(boundary[i - 1], cursor + (end - cursor) * i / threads_count);
+            const char* last = lineEnd(middle, end);
+            boundary[i] = last < end ? last + 1 : end;
+        }
+        this->thread_edges.assign(threads_count, std::vector<Edge<Capacity>>());
+        this->thread_error.assign(threads_count, std::string());
+        long long expected = std::min(this->arcs_count, (long long) (end - cursor) / MIN_ARC_LINE_LENGTH) / threads_count + 1;
+        this->pool->run([this, &boundary, expected](int thread_id) {
+            this->thread_edges[thread_id].reserve((size_t) expected);
+            this->parseChunk(thread_id, boundary[thread_id], boundary[thread_id + 1]);
+        });
+        // report the error found closest to the beginning of the file
+        long long parsed = 0;
+        for (int i = 0; i < threads_count; i++) {
+            parsed += (long long) this->thread_edges[i].size();
+            if (valid && !this->thread_error[i].empty()) {
+                error = this->thread_error[i];
+                valid = false;
+            }
+        }
+        if (valid && parsed != this->arcs_count) {
+            error = "the problem line declares " + std::to_string(this->arcs_count) + " arcs, " + std::to_string(parsed) + " found";
+            valid = false;
+        }
+    }
+    if (data != nullptr) {
+        munmap(data, size);
+    }
+    if (!valid) {
+        std::cerr << "Invalid DIMACS file " << file << ": " << error << std::endl;
+        this->thread_edges.clear();
+    }
+    return valid;
+}
+
+template <typename Capacity>
+int DimacsReader<Capacity>::getVerticesCount() const {
+    return this->vertices_count;
+}
+
+template <typename Capacity>
+int DimacsReader<Capacity>::getSource() const {
+    return this->source;
+}
+
+template <typename Capacity>
+int DimacsReader<Capacity>::getSink() const {
+    return this->sink;
+}
+
+/**
+ * Build the residual graph of a solver from the parsed arcs with a parallel counting sort. Each
+ * thread places the arcs it has parsed after the ones of the previous chunks, so the arcs are in
+ * the order of the file. Each line becomes its own residual pair: unlike GraphBuilder, parallel
+ * and antiparallel arcs are not merged, which would need a sequential pass over all of them.
+ * @param graph the graph to fill, created with the vertices count of the file.
+ */
+template <typename Capacity>
+void DimacsReader<Capacity>::load(BaseGraph<Capacity>& graph) {
+    int threads_count = this->pool->size();
+    int vertices_count = this->vertices_count;
+    // arcs leaving each vertex among the ones parsed by each thread
+    std::vector<std::vector<int>> offset(threads_count);
+    this->pool->run([this, &offset, vertices_count](int thread_id) {
+        offset[thread_id].assign(vertices_count, 0);
+        for (auto &edge : this->thread_edges[thread_id]) {
+            offset[thread_id][edge.u] += 1;
+            offset[thread_id][edge.v] += 1;
+        }
+    });
+    // turn the counts into offsets inside the range of each vertex
+    graph.first_arc.assign(vertices_count + 1, 0);
+    this->pool->run([&offset, &graph, vertices_count, threads_count](int thread_id) {
+        int begin = (int) ((long long) vertices_count * thread_id / threads_count);
+        int end = (int) ((long long) vertices_count * (thread_id + 1) / threads_count);
+        for (int v = begin; v < end; v++) {
+            int degree = 0;
+            for (int i = 0; i < threads_count; i++) {
+                int count = offset[i][v];
+                offset[i][v] = degree;
+                degree += count;
+            }
+            graph.first_arc[v + 1] = degree;
+        }
+    });
+    for (int v = 0; v < vertices_count; v++) {
+        graph.first_arc[v + 1] += graph.first_arc[v];
+    }
+    auto arcs_count = (size_t) graph.first_arc[vertices_count];
+    graph.arc_head.resize(arcs_count);
+    graph.arc_capacity.resize(arcs_count);
+    graph.arc_residual.resize(arcs_count);
+    graph.arc_reverse.resize(arcs_count);
+    this->pool->run([this, &offset, &graph](int thread_id) {
+        auto &position = offset[thread_id];
+        for (auto &edge : this->thread_edges[thread_id]) {
+            int forward = graph.first_arc[edge.u] + position[edge.u]++;
+            int backward = graph.first_arc[edge.v] + position[edge.v]++;
+            graph.arc_head[forward] = edge.v;
+            graph.arc_capacity[forward] = edge.capacity;
+            graph.arc_residual[forward] = edge.capacity;
+            graph.arc_reverse[forward] = backward;
+            graph.arc_head[backward] = edge.u;
+            graph.arc_capacity[backward] = 0;
+            graph.arc_residual[backward] = 0;
+            graph.arc_reverse[backward] = forward;
+        }
+        // the parsed arcs are not needed anymore
+        std::vector<Edge<Capacity>>().swap(this->thread_edges[thread_id]);
+    });
+    graph.edges.clear();
+    graph.current_arc.assign(graph.first_arc.begin(), graph.first_arc.end() - 1);
+    graph.arcs_built = true;
+    graph.solved = false;
+}
+
+/**
+ * Move the parsed arcs out of the reader, instead of loading them into a graph.
+ * @return the arcs of the file, with the vertices numbered from 0.
+ */
+template <typename Capacity>
+std::vector<Edge<Capacity>> DimacsReader<Capacity>::takeEdges() {
+    std::vector<Edge<Capacity>> edges;
+    size_t parsed = 0;
+    for (auto &chunk : this->thread_edges) {
+        parsed += chunk.size();
+    }
+    edges.reserve(parsed);
+    for (auto &chunk : this->thread_edges) {
+        edges.insert(edges.end(), chunk.begin(), chunk.end());
+        std::vector<Edge<Capacity>>().swap(chunk);
+    }
+    return edges;
+}
+
+/**
+ * DIMACS files start with a comment or with the problem line, while the text graph files
+ * start with the index of a vertex.
+ * @param file path of the file.
+ * @return true if the first character that is not a blank is 'c' or 'p'.
+ */
+template <typename Capacity>
+bool DimacsReader<Capacity>::isDimacsFile(const char* file) {
+    std::ifstream input(file);
+    char first = 0;
+    input >> first;
+    return input.good() && (first == 'c' || first == 'p');
+}
+
+INSTANTIATE_FOR_CAPACITIES(DimacsReader)
\ No newline at end of file
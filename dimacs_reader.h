@@ -0,0 +1,65 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_DIMACS_READER_H
+#define ADVANCEDALGORITHMSPROJECT_DIMACS_READER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "base_graph.h"
+#include "thread_pool.h"
+
+/**
+ * Reader for the DIMACS maximum flow format: an optional list of comment lines ("c ..."), the
+ * problem line ("p max V E"), the source and sink lines ("n id s", "n id t") and one line for
+ * each arc ("a u v capacity"), with vertices numbered from 1. The file is mapped in memory and
+ * the arc lines are split in one chunk per thread on line boundaries and parsed concurrently;
+ * the residual graph is then built with a parallel counting sort over the parsed arcs.
+ */
+template <typename Capacity>
+class DimacsReader {
+
+    std::unique_ptr<ThreadPool> pool;
+
+    int vertices_count;
+    long long arcs_count;
+    int source;
+    int sink;
+
+    // arcs parsed by each thread, in the order they appear in its chunk
+    std::vector<std::vector<Edge<Capacity>>> thread_edges;
+
+    // first error found by each thread, empty if its chunk is valid
+    std::vector<std::string> thread_error;
+
+    bool parseHeader(const char* &cursor, const char* end, std::string &error);
+
+    void parseChunk(int thread_id, const char* cursor, const char* end);
+
+    bool parseArc(const char* cursor, const char* end, Edge<Capacity> &edge) const;
+
+public:
+
+    explicit DimacsReader(int threads_count);
+
+    virtual ~DimacsReader();
+
+    bool read(const char* file);
+
+    int getVerticesCount() const;
+
+    int getSource() const;
+
+    int getSink() const;
+
+    void load(BaseGraph<Capacity>& graph);
+
+    std::vector<Edge<Capacity>> takeEdges();
+
+    static bool isDimacsFile(const char* file);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_DIMACS_READER_H
\ No newline at end of file
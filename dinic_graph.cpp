@@ -0,0 +1,150 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <algorithm>
+#include "dinic_graph.h"
+
+#define NO_LEVEL (-1)
+
+template <typename Capacity, typename Statistics>
+DinicGraph<Capacity, Statistics>::DinicGraph(int vertices_count) : BaseGraph<Capacity>(vertices_count) {}
+
+/**
+ * Breadth-first search from the source on the arcs with some residual capacity. The vertices
+ * farther than the sink are never part of a shortest path, so the search stops at its level.
+ * @return true if the sink can still be reached.
+ */
+template <typename Capacity, typename Statistics>
+bool DinicGraph<Capacity, Statistics>::buildLevels() {
+    typename Statistics::Timer start = this->statistics.startTimer();
+    std::fill(this->level.begin(), this->level.end(), NO_LEVEL);
+    std::vector<int> &queue = this->path;
+    queue.clear();
+    queue.push_back(this->source);
+    this->level[this->source] = 0;
+    long long scans = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int u = queue[head];
+        if (this->level[this->sink] != NO_LEVEL && this->level[u] >= this->level[this->sink]) {
+            break;
+        }
+        int end = this->first_arc[u + 1];
+        for (int arc = this->first_arc[u]; arc < end; arc++) {
+            int v = this->arc_head[arc];
+            if (this->level[v] == NO_LEVEL && this->isPositive(this->arc_residual[arc])) {
+                this->level[v] = this->level[u] + 1;
+                queue.push_back(v);
+            }
+        }
+        scans += end - this->first_arc[u];
+    }
+    this->statistics.countArcScans(scans);
+    this->statistics.countGlobalRelabel();
+    this->statistics.addGlobalRelabelTime(start);
+    return this->level[this->sink] != NO_LEVEL;
+}
+
+/**
+ * Saturate every shortest path of the level graph. The search is iterative, since the paths
+ * can be as long as the graph: after an augmentation it resumes from the tail of the first
+ * saturated arc, and a vertex without admissible arcs left is removed from the level graph.
+ * @return the flow sent during the phase.
+ */
+template <typename Capacity, typename Statistics>
+Capacity DinicGraph<Capacity, Statistics>::blockingFlow() {
+    for (size_t i = 0; i < this->vertices.size(); i++) {
+        this->current_arc[i] = this->first_arc[i];
+    }
+    this->path.clear();
+    Capacity flow = 0;
+    int u = this->source;
+    while (true) {
+        if (u == this->sink) {
+            Capacity amount = this->arc_residual[this->path[0]];
+            for (int arc : this->path) {
+                amount = std::min(amount, this->arc_residual[arc]);
+            }
+            size_t saturated = this->path.size();
+            for (size_t i = 0; i < this->path.size(); i++) {
+                int arc = this->path[i];
+                this->arc_residual[arc] -= amount;
+                this->arc_residual[this->arc_reverse[arc]] += amount;
+                if (saturated == this->path.size() && !this->isPositive(this->arc_residual[arc])) {
+                    saturated = i;
+                }
+            }
+            flow += amount;
+            this->statistics.countPush(true);
+            u = this->arc_head[this->arc_reverse[this->path[saturated]]];
+            this->path.resize(saturated);
+            continue;
+        }
+        int end = this->first_arc[u + 1];
+        int &arc = this->current_arc[u];
+        int begin = arc;
+        while (arc < end && (this->level[this->arc_head[arc]] != this->level[u] + 1 || !this->isPositive(this->arc_residual[arc]))) {
+            arc++;
+        }
+        this->statistics.countArcScans(arc - begin);
+        if (arc < end) {
+            this->path.push_back(arc);
+            u = this->arc_head[arc];
+            continue;
+        }
+        // dead end: no shortest path goes through u anymore
+        this->level[u] = NO_LEVEL;
+        this->statistics.countRelabel();
+        if (u == this->source) {
+            break;
+        }
+        int last = this->path.back();
+        this->path.pop_back();
+        u = this->arc_head[this->arc_reverse[last]];
+        this->current_arc[u] += 1;
+    }
+    return flow;
+}
+
+template <typename Capacity, typename Statistics>
+Capacity DinicGraph<Capacity, Statistics>::getMaximumFlow(int s, int t) {
+    this->statistics.reset();
+    typename Statistics::Timer start = this->statistics.startTimer();
+    auto n = (int) this->vertices.size();
+    this->solved = false;
+    this->source = s;
+    this->sink = t;
+    if (!this->arcs_built) {
+        this->buildArcs();
+    }
+    this->arc_residual = this->arc_capacity;
+    this->level.assign(n, NO_LEVEL);
+    this->path.reserve(n);
+    for (int i = 0; i < n; i++) {
+        this->vertices[i].label = DEFAULT_LABEL;
+        this->vertices[i].excess = DEFAULT_EXCESS;
+    }
+    this->statistics.addInitializationTime(start);
+    start = this->statistics.startTimer();
+    Capacity flow = 0;
+    int phases = 0;
+    while (s != t && buildLevels()) {
+        flow += blockingFlow();
+        phases += 1;
+    }
+    this->statistics.addDischargeTime(start);
+    this->vertices[s].excess = -flow;
+    this->vertices[t].excess = flow;
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Phases: " << phases << std::endl;
+        this->printCurrentStatus();
+    }
+    return flow;
+}
+
+template <typename Capacity, typename Statistics>
+SolverStatistics DinicGraph<Capacity, Statistics>::getStatistics() {
+    return this->statistics.get();
+}
+
+INSTANTIATE_FOR_CAPACITIES_AND_STATISTICS(DinicGraph)
\ No newline at end of file
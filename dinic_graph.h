@@ -0,0 +1,43 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_DINIC_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_DINIC_GRAPH_H
+
+#include "base_graph.h"
+#include "solver_statistics.h"
+
+/**
+ * Dinic's algorithm: a breadth-first search from the source splits the residual graph in levels,
+ * then a blocking flow is found with depth-first searches that only follow arcs going one level
+ * up. Every arc is scanned once per phase thanks to the current arc of each vertex, and the
+ * distance of the sink grows at each phase, which gives O(E sqrt(V)) on unit capacity networks.
+ * In the statistics each phase counts as a global relabel, each augmenting path as a saturating
+ * push and each dead end removed from the level graph as a relabel.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class DinicGraph final : public BaseGraph<Capacity> {
+
+    // distance from the source in the residual graph, -1 when not reached or a dead end
+    std::vector<int> level;
+
+    // arcs of the path from the source explored by the current search
+    std::vector<int> path;
+
+    Statistics statistics;
+
+    bool buildLevels();
+
+    Capacity blockingFlow();
+
+public:
+
+    explicit DinicGraph(int vertices_count);
+
+    Capacity getMaximumFlow(int s, int t) override;
+
+    SolverStatistics getStatistics() override;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_DINIC_GRAPH_H
\ No newline at end of file
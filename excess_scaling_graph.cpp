@@ -0,0 +1,232 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include "excess_scaling_graph.h"
+#include "push_relabel_graph_impl.h"
+
+#define NOT_LISTED (-1)
+
+/**
+ * The labels of the vertices never exceed 2 * V - 1, as in the highest-label graph.
+ * @param vertices_count size of the graph.
+ */
+template <typename Capacity, typename Statistics>
+ExcessScalingGraph<Capacity, Statistics>::ExcessScalingGraph(int vertices_count) : Base(vertices_count) {
+    this->list_head.assign(2 * vertices_count, NOT_LISTED);
+    this->next_large.assign(vertices_count, NOT_LISTED);
+    this->previous_large.assign(vertices_count, NOT_LISTED);
+    this->list_label.assign(vertices_count, NOT_LISTED);
+    this->min_large_label = 0;
+    this->lists_valid = false;
+    this->delta = 0;
+}
+
+template <typename Capacity, typename Statistics>
+bool ExcessScalingGraph<Capacity, Statistics>::isLarge(int v) {
+    return this->isActive(v) && this->vertices[v].excess + this->vertices[v].excess > this->delta;
+}
+
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::insertLarge(int v) {
+    int label = this->vertices[v].label;
+    this->previous_large[v] = NOT_LISTED;
+    this->next_large[v] = this->list_head[label];
+    if (this->list_head[label] != NOT_LISTED) {
+        this->previous_large[this->list_head[label]] = v;
+    }
+    this->list_head[label] = v;
+    this->list_label[v] = label;
+    if (label < this->min_large_label) {
+        this->min_large_label = label;
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::removeLarge(int v) {
+    if (this->previous_large[v] != NOT_LISTED) {
+        this->next_large[this->previous_large[v]] = this->next_large[v];
+    } else {
+        this->list_head[this->list_label[v]] = this->next_large[v];
+    }
+    if (this->next_large[v] != NOT_LISTED) {
+        this->previous_large[this->next_large[v]] = this->previous_large[v];
+    }
+    this->list_label[v] = NOT_LISTED;
+}
+
+/**
+ * Start a scaling phase: delta becomes the smallest power of two not below the largest excess,
+ * which is at most half of the previous one, and the vertices above delta / 2 are listed.
+ * @return false if no vertex is active anymore.
+ */
+template <typename Capacity, typename Statistics>
+bool ExcessScalingGraph<Capacity, Statistics>::startPhase() {
+    auto vertices_count = (int) this->vertices.size();
+    std::fill(this->list_head.begin(), this->list_head.end(), NOT_LISTED);
+    std::fill(this->list_label.begin(), this->list_label.end(), NOT_LISTED);
+    this->min_large_label = (int) this->list_head.size();
+    this->lists_valid = true;
+    Capacity largest = 0;
+    for (int v = 0; v < vertices_count; v++) {
+        if (this->isActive(v) && this->vertices[v].excess > largest) {
+            largest = this->vertices[v].excess;
+        }
+    }
+    if (!this->isPositive(largest)) {
+        return false;
+    }
+    this->delta = 1;
+    while (this->delta < largest) {
+        // the largest excess itself is used when the next power of two does not fit the type
+        this->delta = this->delta > largest - this->delta ? largest : this->delta + this->delta;
+    }
+    // fractional capacities can go below one unit
+    while (this->delta / 2 >= largest && this->isPositive(this->delta / 2)) {
+        this->delta /= 2;
+    }
+    for (int v = 0; v < vertices_count; v++) {
+        if (isLarge(v)) {
+            insertLarge(v);
+        }
+    }
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Scaling phase with delta " << this->delta << std::endl;
+    }
+    return true;
+}
+
+/**
+ * Push from u as much flow as possible without bringing the excess of the head above delta.
+ * The source and the sink have no bound, since their excess is never pushed.
+ * @param u index of a vertex with large excess.
+ * @param arc index of an admissible arc leaving u.
+ */
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::scaledPush(int u, int arc) {
+    int i = this->arc_head[arc];
+    Capacity flow = std::min(this->arc_residual[arc], this->vertices[u].excess);
+    if (i != this->source && i != this->sink) {
+        flow = std::min(flow, this->delta - this->vertices[i].excess);
+    }
+    this->vertices[u].excess -= flow;
+    this->vertices[i].excess += flow;
+    this->arc_residual[arc] -= flow;
+    this->arc_residual[this->arc_reverse[arc]] += flow;
+    if (this->lists_valid && this->list_label[i] == NOT_LISTED && isLarge(i)) {
+        insertLarge(i);
+    }
+    this->statistics.countPush(!this->isPositive(this->arc_residual[arc]));
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Flow moved from " << u << " to " << i << " by " << flow << " units" << std::endl;
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::activate(int v) {
+    // the excess is not known yet, the lists are rebuilt before the next selection
+    this->lists_valid = false;
+}
+
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::onLabelsUpdated() {
+    this->lists_valid = false;
+}
+
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::printCurrentStatus() {
+    Base::printCurrentStatus();
+    if (Statistics::enabled && this->verbose && this->lists_valid) {
+        std::cout << "  delta = " << this->delta << ", L = { ";
+        for (int label = this->min_large_label; label < this->list_head.size(); label++) {
+            for (int v = this->list_head[label]; v != NOT_LISTED; v = this->next_large[v]) {
+                std::cout << v << ":" << label << " ";
+            }
+        }
+        std::cout << "}" << std::endl;
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::preProcess(int s, int t) {
+    this->lists_valid = false;
+    Base::preProcess(s, t);
+}
+
+/**
+ * @return the vertex with large excess and the lowest label, starting a new phase when there
+ * are none left.
+ */
+template <typename Capacity, typename Statistics>
+int ExcessScalingGraph<Capacity, Statistics>::getActiveNode(int s, int t) {
+    if (!this->lists_valid && !startPhase()) {
+        return NO_ACTIVE_NODE_FOUND;
+    }
+    // during the first phase only the vertices below V can still reach the sink
+    auto limit = (int) (this->phase_one_only ? this->vertices.size() : this->list_head.size());
+    while (true) {
+        while (this->min_large_label < limit && this->list_head[this->min_large_label] == NOT_LISTED) {
+            this->min_large_label += 1;
+        }
+        if (this->min_large_label < limit) {
+            return this->list_head[this->min_large_label];
+        }
+        if (!startPhase()) {
+            return NO_ACTIVE_NODE_FOUND;
+        }
+    }
+}
+
+/**
+ * Push the excess of u until it is no longer large, relabeling u if its arcs are exhausted first.
+ * A push limited by delta leaves at most delta / 2 units in u, since its head had a small excess
+ * (its label is lower than the lowest one among the large excesses).
+ * @param u index of the vertex with large excess and the lowest label.
+ */
+template <typename Capacity, typename Statistics>
+void ExcessScalingGraph<Capacity, Statistics>::discharge(int u) {
+    int last_arc = this->first_arc[u + 1];
+    int first_scanned = this->current_arc[u];
+    this->statistics.countDischarge();
+    while (isLarge(u) && this->current_arc[u] < last_arc) {
+        int arc = this->current_arc[u];
+        int i = this->arc_head[arc];
+        if (this->isPositive(this->arc_residual[arc]) && this->vertices[u].label > this->vertices[i].label &&
+            (i == this->source || i == this->sink || this->isPositive(this->delta - this->vertices[i].excess))) {
+            scaledPush(u, arc);
+        } else {
+            this->current_arc[u] += 1;
+        }
+    }
+    this->statistics.countArcScans(std::min(this->current_arc[u] + 1, last_arc) - first_scanned);
+    if (isLarge(u)) {
+        if (Statistics::enabled && this->verbose) {
+            std::cout << "=> No admissible arc found, relabeling node " << u << std::endl;
+        }
+        relabel(u);
+        this->current_arc[u] = this->first_arc[u];
+        if (this->global_relabel) {
+            this->relabel_work += GLOBAL_RELABEL_BETA + last_arc - this->first_arc[u];
+            if (this->global_relabel_frequency * this->relabel_work > GLOBAL_RELABEL_ALPHA * this->vertices.size() + this->arc_head.size() / 2) {
+                this->globalRelabel();
+            }
+        }
+    } else if (this->lists_valid && this->list_label[u] != NOT_LISTED) {
+        removeLarge(u);
+    }
+}
+
+template <typename Capacity, typename Statistics>
+bool ExcessScalingGraph<Capacity, Statistics>::relabel(int u) {
+    // the vertex must be moved in the list of its new label
+    if (this->lists_valid) {
+        removeLarge(u);
+    }
+    bool relabeled = Base::relabel(u);
+    if (this->lists_valid && isLarge(u)) {
+        insertLarge(u);
+    }
+    return relabeled;
+}
+
+INSTANTIATE_PUSH_RELABEL_GRAPH(ExcessScalingGraph)
\ No newline at end of file
@@ -0,0 +1,74 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_EXCESS_SCALING_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_EXCESS_SCALING_GRAPH_H
+
+#include "push_relabel_graph.h"
+
+/**
+ * Excess scaling (Ahuja and Orlin): every excess stays below a bound delta, and only the vertices
+ * with a large excess, more than delta / 2, are discharged, the one with the lowest label first.
+ * The pushes are limited so that the head never goes above delta, which makes every push either
+ * saturating or at least delta / 2 units large. When no large excess is left delta is lowered
+ * to the next power of two above the largest excess, so there are O(log U) phases and the work
+ * is O(VE + V^2 log U) on integer capacities bounded by U.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class ExcessScalingGraph final : public PushRelabelGraph<Capacity, Statistics, ExcessScalingGraph<Capacity, Statistics>> {
+
+    typedef PushRelabelGraph<Capacity, Statistics, ExcessScalingGraph<Capacity, Statistics>> Base;
+
+    // the main loop calls the hooks of the selection rule directly
+    friend Base;
+
+    // the vertices with a large excess are kept in lists indexed by label, built on top of the
+    // next/previous arrays as the buckets of the highest-label graph
+    std::vector<int> list_head;
+    std::vector<int> next_large;
+    std::vector<int> previous_large;
+
+    // label of the list that contains the vertex, or -1 if it is not listed
+    std::vector<int> list_label;
+
+    // no list below this label contains a vertex
+    int min_large_label;
+
+    // the lists are rebuilt lazily after the labels or the excesses change outside the pushes
+    bool lists_valid;
+
+    Capacity delta;
+
+    bool isLarge(int v);
+
+    void insertLarge(int v);
+
+    void removeLarge(int v);
+
+    bool startPhase();
+
+    void scaledPush(int u, int arc);
+
+protected:
+
+    void activate(int v);
+
+    void onLabelsUpdated();
+
+public:
+
+    explicit ExcessScalingGraph(int vertices_count);
+
+    void printCurrentStatus() override;
+
+    void preProcess(int s, int t);
+
+    int getActiveNode(int s, int t);
+
+    void discharge(int u);
+
+    bool relabel(int u);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_EXCESS_SCALING_GRAPH_H
\ No newline at end of file
@@ -0,0 +1,96 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include "fifo_graph.h"
+#include "push_relabel_graph_impl.h"
+
+template <typename Capacity, typename Statistics>
+FifoGraph<Capacity, Statistics>::FifoGraph(int vertices_count) : Base(vertices_count) {
+    this->queue.assign(vertices_count, NO_ACTIVE_NODE_FOUND);
+    this->queue_head = 0;
+    this->queue_size = 0;
+    this->queued.assign(vertices_count, false);
+}
+
+template <typename Capacity, typename Statistics>
+void FifoGraph<Capacity, Statistics>::enqueue(int v) {
+    auto capacity = (int) this->queue.size();
+    this->queue[(this->queue_head + this->queue_size) % capacity] = v;
+    this->queue_size += 1;
+    this->queued[v] = true;
+}
+
+template <typename Capacity, typename Statistics>
+int FifoGraph<Capacity, Statistics>::dequeue() {
+    int v = this->queue[this->queue_head];
+    this->queue_head = (this->queue_head + 1) % (int) this->queue.size();
+    this->queue_size -= 1;
+    this->queued[v] = false;
+    return v;
+}
+
+template <typename Capacity, typename Statistics>
+void FifoGraph<Capacity, Statistics>::activate(int v) {
+    // a warm start may activate a vertex that is already waiting
+    if (!this->queued[v]) {
+        enqueue(v);
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void FifoGraph<Capacity, Statistics>::onLabelsUpdated() {
+    // the queue does not depend on the labels, but the vertices dropped by the first phase
+    // must be discharged again when a warm start computes the whole flow
+    for (int v = 0; v < this->vertices.size(); v++) {
+        if (!this->queued[v] && this->isActive(v)) {
+            enqueue(v);
+        }
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void FifoGraph<Capacity, Statistics>::printCurrentStatus() {
+    Base::printCurrentStatus();
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "  Q = { ";
+        for (int k = 0; k < this->queue_size; k++) {
+            std::cout << this->queue[(this->queue_head + k) % this->queue.size()] << " ";
+        }
+        std::cout << "}" << std::endl;
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void FifoGraph<Capacity, Statistics>::preProcess(int s, int t) {
+    // empty the queue before the source saturates its arcs
+    this->queue_head = 0;
+    this->queue_size = 0;
+    this->queued.assign(this->vertices.size(), false);
+    Base::preProcess(s, t);
+}
+
+template <typename Capacity, typename Statistics>
+int FifoGraph<Capacity, Statistics>::getActiveNode(int s, int t) {
+    // drop the vertices that cannot be discharged anymore
+    while (this->queue_size > 0) {
+        int v = this->queue[this->queue_head];
+        if (this->isActive(v)) {
+            return v;
+        }
+        dequeue();
+    }
+    return NO_ACTIVE_NODE_FOUND;
+}
+
+template <typename Capacity, typename Statistics>
+void FifoGraph<Capacity, Statistics>::discharge(int u) {
+    Base::discharge(u);
+    // the vertex is at the head of the queue, it goes to the end if it is still active
+    dequeue();
+    if (this->isActive(u)) {
+        enqueue(u);
+    }
+}
+
+INSTANTIATE_PUSH_RELABEL_GRAPH(FifoGraph)
\ No newline at end of file
@@ -0,0 +1,53 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_FIFO_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_FIFO_GRAPH_H
+
+#include "push_relabel_graph.h"
+
+/**
+ * First-in first-out selection rule: the active vertices wait in a queue and a vertex that is
+ * still active after its discharge goes back to the end of it. Each vertex is in the queue at
+ * most once, so a circular buffer of V elements is enough.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class FifoGraph final : public PushRelabelGraph<Capacity, Statistics, FifoGraph<Capacity, Statistics>> {
+
+    typedef PushRelabelGraph<Capacity, Statistics, FifoGraph<Capacity, Statistics>> Base;
+
+    // the main loop calls the hooks of the selection rule directly
+    friend Base;
+
+    std::vector<int> queue;
+    int queue_head;
+    int queue_size;
+
+    // if the vertex is waiting in the queue
+    std::vector<bool> queued;
+
+    void enqueue(int v);
+
+    int dequeue();
+
+protected:
+
+    void activate(int v);
+
+    void onLabelsUpdated();
+
+public:
+
+    explicit FifoGraph(int vertices_count);
+
+    void printCurrentStatus() override;
+
+    void preProcess(int s, int t);
+
+    int getActiveNode(int s, int t);
+
+    void discharge(int u);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_FIFO_GRAPH_H
\ No newline at end of file
@@ -2,12 +2,16 @@
 // Created by andrea on 09/09/18.
 //
 #include "generic_graph.h"
+#include "push_relabel_graph_impl.h"
 
-int GenericGraph::getActiveNode(int s, int t) {
+template <typename Capacity, typename Statistics>
+int GenericGraph<Capacity, Statistics>::getActiveNode(int s, int t) {
     for (int i = 0; i < this->vertices.size(); i++) {
-        if (i != s && i != t && this->vertices[i].excess > 0) {
+        if (this->isActive(i)) {
             return i;
         }
     }
     return NO_ACTIVE_NODE_FOUND;
-}
\ No newline at end of file
+}
+
+INSTANTIATE_PUSH_RELABEL_GRAPH(GenericGraph)
\ No newline at end of file
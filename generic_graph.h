@@ -5,15 +5,21 @@
 #ifndef ADVANCEDALGORITHMSPROJECT_GENERICGRAPH_H
 #define ADVANCEDALGORITHMSPROJECT_GENERICGRAPH_H
 
-#include "base_graph.h"
+#include "push_relabel_graph.h"
 
-class GenericGraph : public BaseGraph {
+template <typename Capacity, typename Statistics = NoStatistics>
+class GenericGraph final : public PushRelabelGraph<Capacity, Statistics, GenericGraph<Capacity, Statistics>> {
+
+    typedef PushRelabelGraph<Capacity, Statistics, GenericGraph<Capacity, Statistics>> Base;
+
+    // the main loop calls the hooks of the selection rule directly
+    friend Base;
 
 public:
 
-    explicit GenericGraph(int vertices_count) : BaseGraph(vertices_count) {}
+    explicit GenericGraph(int vertices_count) : Base(vertices_count) {}
 
-    int getActiveNode(int s, int t) override;
+    int getActiveNode(int s, int t);
 };
 
 #endif //ADVANCEDALGORITHMSPROJECT_GENERICGRAPH_H
\ No newline at end of file
@@ -1,30 +1,305 @@
 //
 // Created by andrea on 09/09/18.
 //
+#include <iostream>
 #include "goldberg_algorthm_solver.h"
 #include "generic_graph.h"
 #include "lift_to_front_graph.h"
+#include "highest_label_graph.h"
+#include "parallel_graph.h"
+#include "fifo_graph.h"
+#include "dense_graph.h"
+#include "boykov_kolmogorov_graph.h"
+#include "dinic_graph.h"
+#include "excess_scaling_graph.h"
+#include "solver_selector.h"
 
-GoldbergProblemSolver::GoldbergProblemSolver(int vertices_count, SolverType type, bool verbose) {
+/**
+ * The statistics and the verbose output are compiled only in the graphs using CountingStatistics,
+ * so the policy is chosen once here and the default solvers pay nothing for them.
+ * @param vertices_count size of the graph.
+ * @param type the variation of the algorithm.
+ * @param verbose print every step of the algorithm.
+ * @param statistics collect the counters returned by getStatistics().
+ */
+template <typename Capacity>
+GoldbergProblemSolver<Capacity>::GoldbergProblemSolver(int vertices_count, SolverType type, bool verbose, bool statistics) {
+    this->type = type;
+    this->verbose = verbose;
+    this->statistics = statistics;
+    this->reduction = false;
+    this->reducer = nullptr;
+    this->reduced = nullptr;
+    this->ordering = ORIGINAL_ORDER;
+    this->order = nullptr;
+    this->graph = newGraph(vertices_count, type);
+    this->graph->setVerbose(verbose);
+}
+
+/**
+ * Create an empty graph, with the statistics policy chosen by the constructor.
+ * @param vertices_count size of the graph.
+ * @param type the variation of the algorithm.
+ */
+template <typename Capacity>
+BaseGraph<Capacity>* GoldbergProblemSolver<Capacity>::newGraph(int vertices_count, SolverType type) {
+    if (this->verbose || this->statistics) {
+        return createGraph<CountingStatistics>(vertices_count, type);
+    }
+    return createGraph<NoStatistics>(vertices_count, type);
+}
+
+template <typename Capacity>
+template <typename Statistics>
+BaseGraph<Capacity>* GoldbergProblemSolver<Capacity>::createGraph(int vertices_count, SolverType type) {
     switch (type) {
         case GENERIC_SOLVER:
-            this->graph = new GenericGraph(vertices_count);
-            break;
+            return new GenericGraph<Capacity, Statistics>(vertices_count);
         case LIFT_TO_FRONT_SOLVER:
-            this->graph = new LiftToFrontGraph(vertices_count);
-            break;
+            return new LiftToFrontGraph<Capacity, Statistics>(vertices_count);
+        case HIGHEST_LABEL_SOLVER:
+            return new HighestLabelGraph<Capacity, Statistics>(vertices_count);
+        case PARALLEL_SOLVER:
+            return new ParallelGraph<Capacity, Statistics>(vertices_count);
+        case FIFO_SOLVER:
+            return new FifoGraph<Capacity, Statistics>(vertices_count);
+        case DENSE_SOLVER:
+            return new DenseGraph<Capacity, Statistics>(vertices_count);
+        case BOYKOV_KOLMOGOROV_SOLVER:
+            return new BoykovKolmogorovGraph<Capacity, Statistics>(vertices_count);
+        case DINIC_SOLVER:
+            return new DinicGraph<Capacity, Statistics>(vertices_count);
+        case EXCESS_SCALING_SOLVER:
+            return new ExcessScalingGraph<Capacity, Statistics>(vertices_count);
+        case AUTO_SOLVER:
+            // the graph is loaded in the default variation and replaced if another one fits better
+            return new HighestLabelGraph<Capacity, Statistics>(vertices_count);
     }
-    this->graph->setVerbose(verbose);
+    return nullptr;
+}
+
+/**
+ * Choose the variation from the profile of the loaded graph, the first time it is solved in
+ * automatic mode. The arcs are moved into the new graph, so nothing has to be loaded again.
+ * The rules of the selector were measured with global relabel and gap heuristic, without them
+ * the push-relabel variations are up to a thousand times slower, so they are always enabled.
+ * @param s the source vertex.
+ * @param t the sink vertex.
+ */
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::selectGraph(int s, int t) {
+    if (this->type != AUTO_SOLVER) {
+        return;
+    }
+    GraphProfile profile = SolverSelector<Capacity>::getProfile(*this->graph, s, t);
+    this->type = SolverSelector<Capacity>::select(profile);
+    if (this->verbose) {
+        profile.print(std::cout);
+        std::cout << "=> Selected solver mode: " << this->type << std::endl;
+    }
+    this->graph->setGlobalRelabel(true);
+    this->graph->setGapHeuristic(true);
+    if (this->type == HIGHEST_LABEL_SOLVER) {
+        return;
+    }
+    BaseGraph<Capacity>* selected = newGraph(profile.vertices_count, this->type);
+    this->graph->moveTo(*selected);
+    delete this->graph;
+    this->graph = selected;
+}
+
+/**
+ * Rebuild the graph in the chosen order of the vertices, the first time it is solved.
+ * @param t the sink vertex, in the original order.
+ */
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::orderGraph(int t) {
+    if (this->ordering == ORIGINAL_ORDER || this->order != nullptr) {
+        return;
+    }
+    this->order = new VertexOrder<Capacity>(*this->graph, this->ordering, t);
+    BaseGraph<Capacity>* ordered = newGraph(this->order->getVerticesCount(), this->type);
+    this->order->apply(*this->graph, *ordered);
+    delete this->graph;
+    this->graph = ordered;
+}
+
+/**
+ * @param v a vertex given by the caller.
+ * @return its id in the graph, which differs once the graph has been reordered.
+ */
+template <typename Capacity>
+int GoldbergProblemSolver<Capacity>::getGraphVertex(int v) {
+    return this->order != nullptr ? this->order->getNewVertex(v) : v;
+}
+
+template <typename Capacity>
+int GoldbergProblemSolver<Capacity>::getOriginalVertex(int v) {
+    return this->order != nullptr ? this->order->getOriginalVertex(v) : v;
+}
+
+/**
+ * Build the reduced graph for a run between s and t and load it into a new solver of the same
+ * variation and with the same settings. In automatic mode the variation is selected on the
+ * reduced graph, whose profile is the one the solver actually sees.
+ * @param s the source vertex.
+ * @param t the sink vertex.
+ */
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::reduceGraph(int s, int t) {
+    delete this->reduced;
+    delete this->reducer;
+    this->reducer = new GraphReducer<Capacity>(*this->graph, s, t);
+    this->reduced = new GoldbergProblemSolver<Capacity>(this->reducer->getVerticesCount(), this->type, this->verbose, this->statistics);
+    this->reduced->setVertexOrdering(this->ordering);
+    this->graph->copySettings(*this->reduced->graph);
+    if (this->verbose) {
+        std::cout << "=> Reduced graph: " << this->reducer->getVerticesCount() << " of " << this->reducer->getOriginalVerticesCount()
+                  << " vertices, " << this->reducer->getArcsCount() << " edges" << std::endl;
+    }
+    this->reducer->load(*this->reduced->graph);
 }
 
-GoldbergProblemSolver::~GoldbergProblemSolver() {
+template <typename Capacity>
+GoldbergProblemSolver<Capacity>::~GoldbergProblemSolver() {
+    delete this->reduced;
+    delete this->reducer;
+    delete this->order;
     delete this->graph;
 }
 
-void GoldbergProblemSolver::addEdge(int u, int v, int capacity) {
-    this->graph->addEdge(u, v, capacity);
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::addEdge(int u, int v, Capacity capacity) {
+    this->graph->addEdge(getGraphVertex(u), getGraphVertex(v), capacity);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::updateEdgeCapacity(int u, int v, Capacity capacity) {
+    this->graph->updateEdgeCapacity(getGraphVertex(u), getGraphVertex(v), capacity);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::removeEdge(int u, int v) {
+    this->graph->removeEdge(getGraphVertex(u), getGraphVertex(v));
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::loadGraphFile(const GraphFile<Capacity>& file) {
+    file.load(*this->graph);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::loadDimacsFile(DimacsReader<Capacity>& reader) {
+    reader.load(*this->graph);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::loadGraphBuilder(GraphBuilder<Capacity>& builder) {
+    builder.build(*this->graph);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::setGlobalRelabel(bool enabled) {
+    this->graph->setGlobalRelabel(enabled);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::setGlobalRelabelFrequency(double frequency) {
+    this->graph->setGlobalRelabelFrequency(frequency);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::setGapHeuristic(bool enabled) {
+    this->graph->setGapHeuristic(enabled);
+}
+
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::setThreadCount(int threads_count) {
+    this->graph->setThreadCount(threads_count);
+}
+
+/**
+ * Remove the vertices that cannot carry flow between the source and the sink and contract the
+ * chains of the graph before each run. The minimum cut is still given on the original vertices.
+ * The reduced graph is built again by every resolve, so the updates start over from scratch.
+ * @param enabled whether the graph is reduced.
+ */
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::setReduction(bool enabled) {
+    this->reduction = enabled;
+}
+
+/**
+ * Renumber the vertices for a better locality before the first run. The reordering only changes
+ * the layout of the graph, the vertices given to the solver and returned by it keep their ids.
+ * @param ordering the order of the vertices, it has no effect once the graph has been solved.
+ */
+template <typename Capacity>
+void GoldbergProblemSolver<Capacity>::setVertexOrdering(VertexOrdering ordering) {
+    this->ordering = ordering;
+}
+
+template <typename Capacity>
+Capacity GoldbergProblemSolver<Capacity>::getMaximumFlow(int s, int t) {
+    if (this->reduction) {
+        // the reduced graph is ordered instead, it is the one the solver runs on
+        reduceGraph(getGraphVertex(s), getGraphVertex(t));
+        return this->reduced->getMaximumFlow(this->reducer->getReducedVertex(getGraphVertex(s)), this->reducer->getReducedVertex(getGraphVertex(t)));
+    }
+    selectGraph(s, t);
+    orderGraph(t);
+    return this->graph->getMaximumFlow(getGraphVertex(s), getGraphVertex(t));
+}
+
+template <typename Capacity>
+MinimumCut<Capacity> GoldbergProblemSolver<Capacity>::getMinimumCut(int s, int t) {
+    MinimumCut<Capacity> cut;
+    if (this->reduction) {
+        reduceGraph(getGraphVertex(s), getGraphVertex(t));
+        cut = this->reduced->getMinimumCut(this->reducer->getReducedVertex(getGraphVertex(s)), this->reducer->getReducedVertex(getGraphVertex(t)));
+        cut = this->reducer->expandCut(cut);
+    } else {
+        selectGraph(s, t);
+        orderGraph(t);
+        cut = this->graph->getMinimumCut(getGraphVertex(s), getGraphVertex(t));
+    }
+    return this->order != nullptr ? this->order->restoreCut(cut) : cut;
+}
+
+template <typename Capacity>
+Capacity GoldbergProblemSolver<Capacity>::resolveMaximumFlow() {
+    if (this->reducer != nullptr) {
+        return getMaximumFlow(getOriginalVertex(this->reducer->getSource()), getOriginalVertex(this->reducer->getSink()));
+    }
+    return this->graph->resolveMaximumFlow();
+}
+
+template <typename Capacity>
+MinimumCut<Capacity> GoldbergProblemSolver<Capacity>::resolveMinimumCut() {
+    if (this->reducer != nullptr) {
+        return getMinimumCut(getOriginalVertex(this->reducer->getSource()), getOriginalVertex(this->reducer->getSink()));
+    }
+    MinimumCut<Capacity> cut = this->graph->resolveMinimumCut();
+    return this->order != nullptr ? this->order->restoreCut(cut) : cut;
+}
+
+template <typename Capacity>
+SolverStatistics GoldbergProblemSolver<Capacity>::getStatistics() {
+    if (this->reduced != nullptr) {
+        return this->reduced->getStatistics();
+    }
+    return this->graph->getStatistics();
+}
+
+/**
+ * @return the variation solving the graph, AUTO_SOLVER if it has not been selected yet.
+ */
+template <typename Capacity>
+SolverType GoldbergProblemSolver<Capacity>::getSolverType() {
+    if (this->reduced != nullptr) {
+        return this->reduced->getSolverType();
+    }
+    return this->type;
 }
 
-int GoldbergProblemSolver::getMaximumFlow(int s, int t) {
-    this->graph->getMaximumFlow(s, t);
-}
\ No newline at end of file
+INSTANTIATE_FOR_CAPACITIES(GoldbergProblemSolver)
\ No newline at end of file
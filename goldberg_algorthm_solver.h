@@ -6,25 +6,101 @@
 #define ADVANCEDALGORITHMSPROJECT_GOLDBERG_ALGORTHM_SOLVER_H
 
 #include "base_graph.h"
+#include "graph_file.h"
+#include "dimacs_reader.h"
+#include "graph_builder.h"
+#include "graph_reducer.h"
+#include "vertex_order.h"
 
 enum SolverType {
     GENERIC_SOLVER,
-    LIFT_TO_FRONT_SOLVER
+    LIFT_TO_FRONT_SOLVER,
+    HIGHEST_LABEL_SOLVER,
+    PARALLEL_SOLVER,
+    FIFO_SOLVER,
+    DENSE_SOLVER,
+    BOYKOV_KOLMOGOROV_SOLVER,
+    DINIC_SOLVER,
+    EXCESS_SCALING_SOLVER,
+    AUTO_SOLVER
 };
 
+template <typename Capacity>
 class GoldbergProblemSolver {
 
-    BaseGraph* graph;
+    BaseGraph<Capacity>* graph;
+
+    // variation of the graph, AUTO_SOLVER until one is selected by the first run
+    SolverType type;
+
+    bool verbose;
+    bool statistics;
+
+    // solve a reduced copy of the graph, built again for each run
+    bool reduction;
+    GraphReducer<Capacity>* reducer;
+    GoldbergProblemSolver<Capacity>* reduced;
+
+    // the graph is rebuilt in this order by the first run, the vertices are translated from then on
+    VertexOrdering ordering;
+    VertexOrder<Capacity>* order;
+
+    template <typename Statistics>
+    static BaseGraph<Capacity>* createGraph(int vertices_count, SolverType type);
+
+    BaseGraph<Capacity>* newGraph(int vertices_count, SolverType type);
+
+    void selectGraph(int s, int t);
+
+    void orderGraph(int t);
+
+    int getGraphVertex(int v);
+
+    int getOriginalVertex(int v);
+
+    void reduceGraph(int s, int t);
 
 public:
 
-    GoldbergProblemSolver(int vertices_count, SolverType type, bool verbose);
+    GoldbergProblemSolver(int vertices_count, SolverType type, bool verbose, bool statistics = false);
 
     virtual ~GoldbergProblemSolver();
 
-    void addEdge(int u, int v, int capacity);
+    void addEdge(int u, int v, Capacity capacity);
+
+    void updateEdgeCapacity(int u, int v, Capacity capacity);
+
+    void removeEdge(int u, int v);
+
+    void loadGraphFile(const GraphFile<Capacity>& file);
+
+    void loadDimacsFile(DimacsReader<Capacity>& reader);
+
+    void loadGraphBuilder(GraphBuilder<Capacity>& builder);
+
+    void setGlobalRelabel(bool enabled);
+
+    void setGlobalRelabelFrequency(double frequency);
+
+    void setGapHeuristic(bool enabled);
+
+    void setThreadCount(int threads_count);
+
+    void setReduction(bool enabled);
+
+    void setVertexOrdering(VertexOrdering ordering);
+
+    Capacity getMaximumFlow(int s, int t);
+
+    MinimumCut<Capacity> getMinimumCut(int s, int t);
+
+    Capacity resolveMaximumFlow();
+
+    MinimumCut<Capacity> resolveMinimumCut();
+
+    SolverStatistics getStatistics();
 
-    int getMaximumFlow(int s, int t);
+    SolverType getSolverType();
 };
 
 #endif //ADVANCEDALGORITHMSPROJECT_GOLDBERG_ALGORTHM_SOLVER_H
\ No newline at end of file
@@ -0,0 +1,157 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <algorithm>
+#include <memory>
+#include "gomory_hu_tree.h"
+#include "thread_pool.h"
+
+#define NO_SINK (-1)
+
+/**
+ * @param vertices_count size of the graph.
+ * @param type the variation of the algorithm used for the minimum cuts.
+ */
+template <typename Capacity>
+GomoryHuTree<Capacity>::GomoryHuTree(int vertices_count, SolverType type) {
+    this->vertices_count = vertices_count;
+    this->type = type;
+    this->parent.assign(vertices_count, 0);
+    this->parent_cut.assign(vertices_count, 0);
+    this->depth.assign(vertices_count, 0);
+}
+
+/**
+ * Add an undirected edge: the capacity can be used in both directions.
+ * @param u first vertex.
+ * @param v second vertex.
+ * @param capacity capacity of the edge.
+ */
+template <typename Capacity>
+void GomoryHuTree<Capacity>::addEdge(int u, int v, Capacity capacity) {
+    this->edges.emplace_back(u, v, capacity);
+}
+
+/**
+ * Compute the tree. Vertex s is separated from its current parent t, and the vertices after s
+ * that are on its side of the cut and share the same parent are moved under s.
+ * @param threads_count number of cuts computed at the same time.
+ */
+template <typename Capacity>
+void GomoryHuTree<Capacity>::build(int threads_count) {
+    int n = this->vertices_count;
+    std::fill(this->parent.begin(), this->parent.end(), 0);
+    std::fill(this->parent_cut.begin(), this->parent_cut.end(), 0);
+    std::fill(this->depth.begin(), this->depth.end(), 0);
+    if (n < 2) {
+        return;
+    }
+    int threads = std::max(1, std::min(threads_count, n - 1));
+    // one solver for each thread, the builder merges the two directions of each edge
+    std::vector<std::unique_ptr<GoldbergProblemSolver<Capacity>>> solvers;
+    for (int i = 0; i < threads; i++) {
+        solvers.emplace_back(new GoldbergProblemSolver<Capacity>(n, this->type, false));
+        solvers[i]->setGlobalRelabel(true);
+        solvers[i]->setGapHeuristic(true);
+        solvers[i]->setThreadCount(1);
+        GraphBuilder<Capacity> builder(n);
+        builder.reserve(2 * this->edges.size());
+        for (auto &edge : this->edges) {
+            builder.addEdge(edge.u, edge.v, edge.capacity);
+            builder.addEdge(edge.v, edge.u, edge.capacity);
+        }
+        solvers[i]->loadGraphBuilder(builder);
+    }
+    ThreadPool pool(threads);
+    // last cut computed for each vertex, valid while its parent is still the same sink
+    std::vector<int> cut_sink(n, NO_SINK);
+    std::vector<Capacity> cut_value(n, 0);
+    std::vector<std::vector<int>> cut_side(n);
+    std::vector<bool> in_side(n, false);
+    std::vector<int> window;
+    int next = 1;
+    while (next < n) {
+        // the cuts still missing for the next vertices, the first one is always needed
+        window.clear();
+        for (int s = next; s < n && (int) window.size() < threads; s++) {
+            if (cut_sink[s] != this->parent[s]) {
+                window.push_back(s);
+            }
+        }
+        pool.run([&](int thread_id) {
+            if (thread_id >= (int) window.size()) {
+                return;
+            }
+            int s = window[thread_id];
+            int t = this->parent[s];
+            MinimumCut<Capacity> cut = solvers[thread_id]->getMinimumCut(s, t);
+            cut_sink[s] = t;
+            cut_value[s] = cut.value;
+            cut_side[s].swap(cut.source_side);
+        });
+        // apply the cuts in order while they were computed with the right parent
+        for (; next < n && cut_sink[next] == this->parent[next]; next++) {
+            int t = this->parent[next];
+            this->parent_cut[next] = cut_value[next];
+            for (int v : cut_side[next]) {
+                in_side[v] = true;
+            }
+            for (int i = next + 1; i < n; i++) {
+                if (in_side[i] && this->parent[i] == t) {
+                    this->parent[i] = next;
+                }
+            }
+            for (int v : cut_side[next]) {
+                in_side[v] = false;
+            }
+            std::vector<int>().swap(cut_side[next]);
+        }
+    }
+    // each vertex is moved only under a previous one, so its parent always comes first
+    for (int v = 1; v < n; v++) {
+        this->depth[v] = this->depth[this->parent[v]] + 1;
+    }
+}
+
+/**
+ * @param v index of a vertex.
+ * @return the parent of the vertex in the tree, 0 for the root.
+ */
+template <typename Capacity>
+int GomoryHuTree<Capacity>::getParent(int v) const {
+    return this->parent[v];
+}
+
+/**
+ * @param v index of a vertex different from the root.
+ * @return the value of the minimum cut between the vertex and its parent.
+ */
+template <typename Capacity>
+Capacity GomoryHuTree<Capacity>::getParentCut(int v) const {
+    return this->parent_cut[v];
+}
+
+/**
+ * Walk up from the deeper vertex until the two paths meet, in O(depth) time.
+ * @param u first vertex.
+ * @param v second vertex, different from the first one.
+ * @return the value of the minimum cut between u and v.
+ */
+template <typename Capacity>
+Capacity GomoryHuTree<Capacity>::getMinimumCut(int u, int v) const {
+    Capacity minimum = 0;
+    bool found = false;
+    while (u != v) {
+        if (this->depth[u] < this->depth[v]) {
+            std::swap(u, v);
+        }
+        if (!found || this->parent_cut[u] < minimum) {
+            minimum = this->parent_cut[u];
+            found = true;
+        }
+        u = this->parent[u];
+    }
+    return minimum;
+}
+
+INSTANTIATE_FOR_CAPACITIES(GomoryHuTree)
\ No newline at end of file
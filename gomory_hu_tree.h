@@ -0,0 +1,53 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_GOMORY_HU_TREE_H
+#define ADVANCEDALGORITHMSPROJECT_GOMORY_HU_TREE_H
+
+#include <vector>
+#include "base_graph.h"
+#include "goldberg_algorthm_solver.h"
+
+/**
+ * Minimum cuts between all the pairs of vertices of an undirected graph, computed with the
+ * algorithm of Gusfield: V - 1 minimum cuts give a tree on the vertices where the minimum cut
+ * between any two of them is the lightest edge on the path connecting them.
+ *
+ * The cuts are computed by a pool of threads, each one with its own solver loaded once: every
+ * run starts from the capacities again, so no graph is built twice. The cut of vertex s only
+ * depends on its parent when it is computed, so the threads compute the cuts of the next
+ * vertices in advance and they are applied in order, computing again the few whose parent has
+ * been changed by the previous ones.
+ */
+template <typename Capacity>
+class GomoryHuTree {
+
+    int vertices_count;
+
+    SolverType type;
+
+    // each edge connects the two vertices in both directions
+    std::vector<Edge<Capacity>> edges;
+
+    // tree rooted in vertex 0: parent of each vertex, weight of the edge to it and depth
+    std::vector<int> parent;
+    std::vector<Capacity> parent_cut;
+    std::vector<int> depth;
+
+public:
+
+    GomoryHuTree(int vertices_count, SolverType type);
+
+    void addEdge(int u, int v, Capacity capacity);
+
+    void build(int threads_count);
+
+    int getParent(int v) const;
+
+    Capacity getParentCut(int v) const;
+
+    Capacity getMinimumCut(int u, int v) const;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_GOMORY_HU_TREE_H
\ No newline at end of file
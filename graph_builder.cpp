@@ -0,0 +1,139 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <algorithm>
+#include "graph_builder.h"
+
+template <typename Capacity>
+GraphBuilder<Capacity>::GraphBuilder(int vertices_count) {
+    this->vertices_count = vertices_count;
+}
+
+/**
+ * Take the ownership of a list of edges, without copying it.
+ * @param vertices_count size of the graph.
+ * @param edges the edges of the graph.
+ */
+template <typename Capacity>
+GraphBuilder<Capacity>::GraphBuilder(int vertices_count, std::vector<Edge<Capacity>> edges) {
+    this->vertices_count = vertices_count;
+    this->edges.swap(edges);
+}
+
+template <typename Capacity>
+void GraphBuilder<Capacity>::reserve(size_t edges_count) {
+    this->edges.reserve(edges_count);
+}
+
+template <typename Capacity>
+void GraphBuilder<Capacity>::addEdge(int u, int v, Capacity capacity) {
+    this->edges.emplace_back(u, v, capacity);
+}
+
+template <typename Capacity>
+int GraphBuilder<Capacity>::getVerticesCount() const {
+    return this->vertices_count;
+}
+
+template <typename Capacity>
+size_t GraphBuilder<Capacity>::getEdgesCount() const {
+    return this->edges.size();
+}
+
+/**
+ * Freeze the edges into the residual graph, replacing its arcs. The edges are grouped by their
+ * pair of endpoints with two counting sorts, then each group becomes a single residual pair.
+ * The arcs of each vertex end up sorted by head, and the edges of the builder are released.
+ * Self loops never carry any flow, so they are dropped.
+ * @param graph the graph to fill, created with the vertices count of the builder.
+ */
+template <typename Capacity>
+void GraphBuilder<Capacity>::build(BaseGraph<Capacity>& graph) {
+    int n = this->vertices_count;
+    // sort the edges by their higher endpoint, then stably by the lower one
+    std::vector<int> count(n + 1, 0);
+    for (auto &edge : this->edges) {
+        count[std::max(edge.u, edge.v) + 1] += 1;
+    }
+    for (int i = 0; i < n; i++) {
+        count[i + 1] += count[i];
+    }
+    std::vector<int> by_higher(this->edges.size());
+    for (int e = 0; e < this->edges.size(); e++) {
+        by_higher[count[std::max(this->edges[e].u, this->edges[e].v)]++] = e;
+    }
+    count.assign(n + 1, 0);
+    for (auto &edge : this->edges) {
+        count[std::min(edge.u, edge.v) + 1] += 1;
+    }
+    for (int i = 0; i < n; i++) {
+        count[i + 1] += count[i];
+    }
+    std::vector<int> order(this->edges.size());
+    for (int e : by_higher) {
+        order[count[std::min(this->edges[e].u, this->edges[e].v)]++] = e;
+    }
+    std::vector<int>().swap(by_higher);
+    // merge each group of edges between the same two vertices into one pair
+    std::vector<int> pair_lower, pair_higher;
+    std::vector<Capacity> pair_up, pair_down;
+    for (int k = 0; k < order.size();) {
+        const Edge<Capacity> &first = this->edges[order[k]];
+        int lower = std::min(first.u, first.v);
+        int higher = std::max(first.u, first.v);
+        Capacity up = 0;
+        Capacity down = 0;
+        for (; k < order.size(); k++) {
+            const Edge<Capacity> &edge = this->edges[order[k]];
+            if (std::min(edge.u, edge.v) != lower || std::max(edge.u, edge.v) != higher) {
+                break;
+            }
+            if (edge.u < edge.v) {
+                up += edge.capacity;
+            } else {
+                down += edge.capacity;
+            }
+        }
+        if (lower != higher) {
+            pair_lower.push_back(lower);
+            pair_higher.push_back(higher);
+            pair_up.push_back(up);
+            pair_down.push_back(down);
+        }
+    }
+    std::vector<int>().swap(order);
+    std::vector<Edge<Capacity>>().swap(this->edges);
+    // place the two arcs of each pair in the ranges of their tails
+    graph.first_arc.assign(n + 1, 0);
+    for (int p = 0; p < pair_lower.size(); p++) {
+        graph.first_arc[pair_lower[p] + 1] += 1;
+        graph.first_arc[pair_higher[p] + 1] += 1;
+    }
+    for (int i = 0; i < n; i++) {
+        graph.first_arc[i + 1] += graph.first_arc[i];
+    }
+    auto arcs_count = (size_t) graph.first_arc[n];
+    graph.arc_head.resize(arcs_count);
+    graph.arc_capacity.resize(arcs_count);
+    graph.arc_residual.resize(arcs_count);
+    graph.arc_reverse.resize(arcs_count);
+    std::vector<int> position(graph.first_arc.begin(), graph.first_arc.end() - 1);
+    for (int p = 0; p < pair_lower.size(); p++) {
+        int forward = position[pair_lower[p]]++;
+        int backward = position[pair_higher[p]]++;
+        graph.arc_head[forward] = pair_higher[p];
+        graph.arc_capacity[forward] = pair_up[p];
+        graph.arc_residual[forward] = pair_up[p];
+        graph.arc_reverse[forward] = backward;
+        graph.arc_head[backward] = pair_lower[p];
+        graph.arc_capacity[backward] = pair_down[p];
+        graph.arc_residual[backward] = pair_down[p];
+        graph.arc_reverse[backward] = forward;
+    }
+    graph.edges.clear();
+    graph.current_arc.assign(graph.first_arc.begin(), graph.first_arc.end() - 1);
+    graph.arcs_built = true;
+    graph.solved = false;
+}
+
+INSTANTIATE_FOR_CAPACITIES(GraphBuilder)
\ No newline at end of file
@@ -0,0 +1,54 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_GRAPH_BUILDER_H
+#define ADVANCEDALGORITHMSPROJECT_GRAPH_BUILDER_H
+
+#include <vector>
+#include "base_graph.h"
+
+/**
+ * Collects the edges of a graph in a single array and freezes them into the residual graph of a
+ * solver. Parallel edges are merged into one arc and each pair of antiparallel edges shares the
+ * same residual pair, the capacity of u->v on the forward arc and the one of v->u on its reverse,
+ * so every pair of adjacent vertices is connected by exactly two arcs.
+ */
+template <typename Capacity>
+class GraphBuilder {
+
+    int vertices_count;
+
+    // all the edges received, kept until the graph is frozen
+    std::vector<Edge<Capacity>> edges;
+
+public:
+
+    explicit GraphBuilder(int vertices_count);
+
+    GraphBuilder(int vertices_count, std::vector<Edge<Capacity>> edges);
+
+    void reserve(size_t edges_count);
+
+    void addEdge(int u, int v, Capacity capacity);
+
+    /**
+     * Add all the edges of a range, each element must have the u, v and capacity fields of Edge.
+     * @param begin iterator to the first edge.
+     * @param end iterator past the last edge.
+     */
+    template <typename Iterator>
+    void addEdges(Iterator begin, Iterator end) {
+        for (Iterator it = begin; it != end; ++it) {
+            this->edges.emplace_back(it->u, it->v, (Capacity) it->capacity);
+        }
+    }
+
+    int getVerticesCount() const;
+
+    size_t getEdgesCount() const;
+
+    void build(BaseGraph<Capacity>& graph);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_GRAPH_BUILDER_H
\ No newline at end of file
@@ -0,0 +1,146 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <algorithm>
+#include <fstream>
+#include <sys/stat.h>
+#include "graph_cache.h"
+
+/**
+ * Load the graph into a solver that has just been created with vertices_count vertices.
+ * @param solver the solver receiving a copy of the graph.
+ */
+template <typename Capacity>
+void CachedGraph<Capacity>::load(GoldbergProblemSolver<Capacity> &solver) const {
+    if (this->file != nullptr) {
+        solver.loadGraphFile(*this->file);
+        return;
+    }
+    GraphBuilder<Capacity> builder(this->vertices_count, this->edges);
+    solver.loadGraphBuilder(builder);
+}
+
+/**
+ * Read a text, DIMACS or binary graph file.
+ * @param path path of the file.
+ * @param error set to the reason of the failure.
+ * @return the graph, null if the file cannot be read.
+ */
+template <typename Capacity>
+std::shared_ptr<CachedGraph<Capacity>> CachedGraph<Capacity>::read(const std::string &path, std::string &error) {
+    const char* file = path.c_str();
+    if (GraphFile<Capacity>::isGraphFile(file)) {
+        std::shared_ptr<CachedGraph<Capacity>> graph(new CachedGraph<Capacity>());
+        graph->file.reset(new GraphFile<Capacity>());
+        // open() checks the whole residual graph, a corrupted file is never cached
+        if (!graph->file->open(file)) {
+            error = "invalid binary graph file " + path;
+            return nullptr;
+        }
+        graph->vertices_count = graph->file->getVerticesCount();
+        graph->source = -1;
+        graph->sink = -1;
+        return graph;
+    }
+    if (DimacsReader<Capacity>::isDimacsFile(file)) {
+        // the jobs already run in parallel, the file is parsed by one thread
+        DimacsReader<Capacity> reader(1);
+        if (!reader.read(file)) {
+            error = "invalid DIMACS file " + path;
+            return nullptr;
+        }
+        std::shared_ptr<CachedGraph<Capacity>> graph = fromEdges(reader.takeEdges());
+        graph->vertices_count = reader.getVerticesCount();
+        graph->source = reader.getSource();
+        graph->sink = reader.getSink();
+        return graph;
+    }
+    std::ifstream input(file);
+    if (!input) {
+        error = "unable to open the graph file " + path;
+        return nullptr;
+    }
+    std::vector<Edge<Capacity>> edges;
+    int u, v;
+    Capacity capacity;
+    while (input >> u >> v >> capacity) {
+        if (u < 0 || v < 0) {
+            error = "negative vertex in the graph file " + path;
+            return nullptr;
+        }
+        edges.emplace_back(u, v, capacity);
+    }
+    return fromEdges(std::move(edges));
+}
+
+/**
+ * @param edges the edges of the graph, whose vertices are numbered from 0.
+ * @return a graph with as many vertices as the highest index found in the edges, plus one.
+ */
+template <typename Capacity>
+std::shared_ptr<CachedGraph<Capacity>> CachedGraph<Capacity>::fromEdges(std::vector<Edge<Capacity>> edges) {
+    std::shared_ptr<CachedGraph<Capacity>> graph(new CachedGraph<Capacity>());
+    graph->vertices_count = 0;
+    for (auto &edge : edges) {
+        graph->vertices_count = std::max(graph->vertices_count, std::max(edge.u, edge.v) + 1);
+    }
+    graph->source = -1;
+    graph->sink = -1;
+    graph->edges.swap(edges);
+    return graph;
+}
+
+template <typename Capacity>
+GraphCache<Capacity>::GraphCache(size_t capacity) {
+    this->capacity = std::max((size_t) 1, capacity);
+}
+
+/**
+ * Find a graph in the cache, reading it if it is missing or if its file has changed. The file is
+ * read without holding the lock, so the other jobs are not stopped by a large graph.
+ * @param path path of the file.
+ * @param error set to the reason of the failure.
+ * @return the graph, null if the file cannot be read.
+ */
+template <typename Capacity>
+std::shared_ptr<const CachedGraph<Capacity>> GraphCache<Capacity>::get(const std::string &path, std::string &error) {
+    struct stat status {};
+    if (stat(path.c_str(), &status) != 0) {
+        error = "unable to find the graph file " + path;
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for (auto it = this->entries.begin(); it != this->entries.end(); ++it) {
+            if (it->path != path) {
+                continue;
+            }
+            if (it->modified == status.st_mtime && it->size == status.st_size) {
+                this->entries.splice(this->entries.begin(), this->entries, it);
+                return it->graph;
+            }
+            this->entries.erase(it);
+            break;
+        }
+    }
+    std::shared_ptr<const CachedGraph<Capacity>> graph = CachedGraph<Capacity>::read(path, error);
+    if (graph == nullptr) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // another job may have read the same file in the meantime
+    for (auto it = this->entries.begin(); it != this->entries.end(); ++it) {
+        if (it->path == path) {
+            this->entries.erase(it);
+            break;
+        }
+    }
+    this->entries.push_front(Entry {path, status.st_mtime, status.st_size, graph});
+    if (this->entries.size() > this->capacity) {
+        this->entries.pop_back();
+    }
+    return graph;
+}
+
+INSTANTIATE_FOR_CAPACITIES(CachedGraph)
+INSTANTIATE_FOR_CAPACITIES(GraphCache)
\ No newline at end of file
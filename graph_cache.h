@@ -0,0 +1,72 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_GRAPH_CACHE_H
+#define ADVANCEDALGORITHMSPROJECT_GRAPH_CACHE_H
+
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "goldberg_algorthm_solver.h"
+
+/**
+ * Graph kept in memory between the jobs of the server. The text and DIMACS files are kept as
+ * their list of edges and the binary files stay mapped, so every job can load its own solver
+ * from the same instance without reading the file again.
+ */
+template <typename Capacity>
+struct CachedGraph {
+
+    int vertices_count;
+
+    // terminals given by a DIMACS file, -1 for the other formats
+    int source;
+    int sink;
+
+    std::vector<Edge<Capacity>> edges;
+
+    std::unique_ptr<GraphFile<Capacity>> file;
+
+    void load(GoldbergProblemSolver<Capacity> &solver) const;
+
+    static std::shared_ptr<CachedGraph<Capacity>> read(const std::string &path, std::string &error);
+
+    static std::shared_ptr<CachedGraph<Capacity>> fromEdges(std::vector<Edge<Capacity>> edges);
+};
+
+/**
+ * The graphs read most recently, shared by all the threads of the server. A graph is read again
+ * when its file is modified, and the least recently used one is dropped when the cache is full.
+ * The jobs still running on a dropped graph keep it alive until they finish.
+ */
+template <typename Capacity>
+class GraphCache {
+
+    struct Entry {
+
+        std::string path;
+        time_t modified;
+        off_t size;
+        std::shared_ptr<const CachedGraph<Capacity>> graph;
+
+    };
+
+    std::mutex mutex;
+
+    // most recently used first
+    std::list<Entry> entries;
+
+    size_t capacity;
+
+public:
+
+    explicit GraphCache(size_t capacity);
+
+    std::shared_ptr<const CachedGraph<Capacity>> get(const std::string &path, std::string &error);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_GRAPH_CACHE_H
\ No newline at end of file
@@ -0,0 +1,283 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <type_traits>
+#include <memory>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graph_file.h"
+#include "dimacs_reader.h"
+#include "generic_graph.h"
+
+template <typename Capacity>
+GraphFile<Capacity>::GraphFile() {
+    this->data = nullptr;
+    this->size = 0;
+    this->header = nullptr;
+    this->first_arc = nullptr;
+    this->arc_head = nullptr;
+    this->arc_reverse = nullptr;
+    this->arc_capacity = nullptr;
+}
+
+template <typename Capacity>
+GraphFile<Capacity>::~GraphFile() {
+    close();
+}
+
+template <typename Capacity>
+size_t GraphFile<Capacity>::align(size_t offset) {
+    return (offset + 7) & ~((size_t) 7);
+}
+
+/**
+ * Map a binary graph file in memory and check that it describes a valid residual graph
+ * with the capacity type of this instance. The whole graph is checked, in time linear in
+ * its size, since the solvers trust the arcs they read.
+ * @param file path of the binary graph file.
+ * @return true if the file can be loaded, false otherwise.
+ */
+template <typename Capacity>
+bool GraphFile<Capacity>::open(const char* file) {
+    close();
+    int descriptor = ::open(file, O_RDONLY);
+    if (descriptor < 0) {
+        std::cerr << "Unable to open the graph file " << file << std::endl;
+        return false;
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t) sizeof(GraphFileHeader)) {
+        std::cerr << "The graph file " << file << " is too short" << std::endl;
+        ::close(descriptor);
+        return false;
+    }
+    this->size = (size_t) status.st_size;
+    this->data = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // the mapping stays valid once the descriptor is closed
+    ::close(descriptor);
+    if (this->data == MAP_FAILED) {
+        std::cerr << "Unable to map the graph file " << file << std::endl;
+        this->data = nullptr;
+        this->size = 0;
+        return false;
+    }
+    // the arrays are read once from the beginning to the end
+    madvise(this->data, this->size, MADV_SEQUENTIAL);
+    this->header = static_cast<const GraphFileHeader*>(this->data);
+    if (this->header->magic != GRAPH_FILE_MAGIC || this->header->version != GRAPH_FILE_VERSION) {
+        std::cerr << "The file " << file << " is not a binary graph file" << std::endl;
+        close();
+        return false;
+    }
+    if (this->header->capacity_size != sizeof(Capacity) || this->header->capacity_floating != (std::is_floating_point<Capacity>::value ? 1u : 0u)) {
+        std::cerr << "The graph file " << file << " was written with a different capacity type" << std::endl;
+        close();
+        return false;
+    }
+    // the counts are checked before any offset is computed from them, so that none can wrap
+    if (this->header->vertices_count < 0 || this->header->vertices_count >= INT_MAX
+        || this->header->arcs_count < 0 || this->header->arcs_count > INT_MAX) {
+        std::cerr << "The graph file " << file << " is corrupted" << std::endl;
+        close();
+        return false;
+    }
+    auto vertices_count = (size_t) this->header->vertices_count;
+    auto arcs_count = (size_t) this->header->arcs_count;
+    // locate the arrays after the header
+    auto bytes = static_cast<const char*>(this->data);
+    size_t offset = align(sizeof(GraphFileHeader));
+    size_t first_arc_offset = offset;
+    offset = align(offset + (vertices_count + 1) * sizeof(int));
+    size_t arc_head_offset = offset;
+    offset = align(offset + arcs_count * sizeof(int));
+    size_t arc_reverse_offset = offset;
+    offset = align(offset + arcs_count * sizeof(int));
+    size_t arc_capacity_offset = offset;
+    offset += arcs_count * sizeof(Capacity);
+    if (offset > this->size) {
+        std::cerr << "The graph file " << file << " is truncated" << std::endl;
+        close();
+        return false;
+    }
+    this->first_arc = reinterpret_cast<const int*>(bytes + first_arc_offset);
+    this->arc_head = reinterpret_cast<const int*>(bytes + arc_head_offset);
+    this->arc_reverse = reinterpret_cast<const int*>(bytes + arc_reverse_offset);
+    this->arc_capacity = reinterpret_cast<const Capacity*>(bytes + arc_capacity_offset);
+    if (!isValid()) {
+        std::cerr << "The graph file " << file << " is corrupted" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Check the mapped arrays in a single pass, so that a solver never follows an arc out of the
+ * graph: the ranges of arcs must cover all the arcs in order, every head and reverse arc must
+ * exist and every arc must be the reverse of its reverse arc, which leaves its head.
+ * @return true if the arrays describe a residual graph.
+ */
+template <typename Capacity>
+bool GraphFile<Capacity>::isValid() const {
+    auto vertices_count = (int) this->header->vertices_count;
+    auto arcs_count = (int) this->header->arcs_count;
+    if (this->first_arc[0] != 0 || this->first_arc[vertices_count] != arcs_count) {
+        return false;
+    }
+    for (int v = 0; v < vertices_count; v++) {
+        if (this->first_arc[v] > this->first_arc[v + 1]) {
+            return false;
+        }
+    }
+    for (int v = 0; v < vertices_count; v++) {
+        for (int arc = this->first_arc[v]; arc < this->first_arc[v + 1]; arc++) {
+            int head = this->arc_head[arc];
+            int reverse = this->arc_reverse[arc];
+            if (head < 0 || head >= vertices_count || reverse < 0 || reverse >= arcs_count) {
+                return false;
+            }
+            if (this->arc_reverse[reverse] != arc || reverse < this->first_arc[head] || reverse >= this->first_arc[head + 1]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Capacity>
+void GraphFile<Capacity>::close() {
+    if (this->data != nullptr) {
+        munmap(this->data, this->size);
+    }
+    this->data = nullptr;
+    this->size = 0;
+    this->header = nullptr;
+    this->first_arc = nullptr;
+    this->arc_head = nullptr;
+    this->arc_reverse = nullptr;
+    this->arc_capacity = nullptr;
+}
+
+template <typename Capacity>
+int GraphFile<Capacity>::getVerticesCount() const {
+    return (int) this->header->vertices_count;
+}
+
+template <typename Capacity>
+int GraphFile<Capacity>::getArcsCount() const {
+    return (int) this->header->arcs_count;
+}
+
+/**
+ * Use the mapped arrays as the residual graph of a solver. The graph must have been created
+ * with the vertices count of the file and any edge added before is discarded.
+ * @param graph the graph to fill.
+ */
+template <typename Capacity>
+void GraphFile<Capacity>::load(BaseGraph<Capacity>& graph) const {
+    auto vertices_count = this->header->vertices_count;
+    auto arcs_count = this->header->arcs_count;
+    graph.edges.clear();
+    graph.first_arc.assign(this->first_arc, this->first_arc + vertices_count + 1);
+    graph.arc_head.assign(this->arc_head, this->arc_head + arcs_count);
+    graph.arc_reverse.assign(this->arc_reverse, this->arc_reverse + arcs_count);
+    graph.arc_capacity.assign(this->arc_capacity, this->arc_capacity + arcs_count);
+    // the residual capacities are written by the solver, so they cannot live in the mapping
+    graph.arc_residual.assign(this->arc_capacity, this->arc_capacity + arcs_count);
+    graph.current_arc.assign(this->first_arc, this->first_arc + vertices_count);
+    graph.arcs_built = true;
+    graph.solved = false;
+}
+
+/**
+ * Check the first bytes of a file to know whether it is a binary graph file or a text one.
+ * @param file path of the file.
+ * @return true if the file starts with the binary graph file magic number.
+ */
+template <typename Capacity>
+bool GraphFile<Capacity>::isGraphFile(const char* file) {
+    std::ifstream input(file, std::ios::binary);
+    uint32_t magic = 0;
+    input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return input.good() && magic == GRAPH_FILE_MAGIC;
+}
+
+/**
+ * Convert a text graph file, one "u v capacity" edge per line, or a DIMACS file, recognized by
+ * DimacsReader::isDimacsFile, into a binary graph file holding the residual graph built by the
+ * solvers. The source and the sink of a DIMACS file are not kept, they are given when solving.
+ * @param input path of the text graph file or of the DIMACS file.
+ * @param output path of the binary graph file to write.
+ * @return true if the conversion succeeded, false otherwise.
+ */
+template <typename Capacity>
+bool GraphFile<Capacity>::convert(const char* input, const char* output) {
+    std::unique_ptr<BaseGraph<Capacity>> graph;
+    if (DimacsReader<Capacity>::isDimacsFile(input)) {
+        // the source and the sink of a DIMACS file are not stored, they are given when solving
+        DimacsReader<Capacity> reader(0);
+        if (!reader.read(input)) {
+            return false;
+        }
+        graph.reset(new GenericGraph<Capacity>(reader.getVerticesCount()));
+        reader.load(*graph);
+    } else {
+        std::ifstream infile(input);
+        if (!infile) {
+            std::cerr << "Unable to open the graph file " << input << std::endl;
+            return false;
+        }
+        std::vector<Edge<Capacity>> edges;
+        int u, v;
+        Capacity capacity;
+        int maximum = -1;
+        while (infile >> u >> v >> capacity) {
+            edges.emplace_back(u, v, capacity);
+            maximum = std::max(maximum, std::max(u, v));
+        }
+        // let the graph build its arcs as it would do before solving
+        graph.reset(new GenericGraph<Capacity>(maximum + 1));
+        graph->edges.swap(edges);
+        graph->buildArcs();
+    }
+    GraphFileHeader header {};
+    header.magic = GRAPH_FILE_MAGIC;
+    header.version = GRAPH_FILE_VERSION;
+    header.capacity_size = sizeof(Capacity);
+    header.capacity_floating = std::is_floating_point<Capacity>::value ? 1u : 0u;
+    header.vertices_count = (int64_t) graph->vertices.size();
+    header.arcs_count = (int64_t) graph->arc_head.size();
+    std::ofstream outfile(output, std::ios::binary | std::ios::trunc);
+    if (!outfile) {
+        std::cerr << "Unable to create the graph file " << output << std::endl;
+        return false;
+    }
+    // every array starts at a multiple of 8 bytes, the gaps are filled with zeros
+    const char padding[8] = {};
+    size_t offset = 0;
+    auto write = [&](const void* bytes, size_t length) {
+        outfile.write(padding, align(offset) - offset);
+        offset = align(offset);
+        outfile.write(static_cast<const char*>(bytes), length);
+        offset += length;
+    };
+    write(&header, sizeof(header));
+    write(graph->first_arc.data(), graph->first_arc.size() * sizeof(int));
+    write(graph->arc_head.data(), graph->arc_head.size() * sizeof(int));
+    write(graph->arc_reverse.data(), graph->arc_reverse.size() * sizeof(int));
+    write(graph->arc_capacity.data(), graph->arc_capacity.size() * sizeof(Capacity));
+    outfile.close();
+    if (!outfile) {
+        std::cerr << "Unable to write the graph file " << output << std::endl;
+        return false;
+    }
+    return true;
+}
+
+INSTANTIATE_FOR_CAPACITIES(GraphFile)
\ No newline at end of file
@@ -0,0 +1,76 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_GRAPH_FILE_H
+#define ADVANCEDALGORITHMSPROJECT_GRAPH_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "base_graph.h"
+
+// first bytes of a binary graph file ("AAGF" in little endian)
+#define GRAPH_FILE_MAGIC 0x46474141u
+#define GRAPH_FILE_VERSION 1u
+
+/**
+ * Fixed size header at the beginning of a binary graph file. It is followed by the residual
+ * graph in forward-star layout: first_arc (V + 1 entries), arc_head, arc_reverse and
+ * arc_capacity (one entry per arc), each array starting at a multiple of 8 bytes.
+ */
+struct GraphFileHeader {
+
+    uint32_t magic;
+    uint32_t version;
+
+    // size in bytes of a capacity and whether it is a floating point number
+    uint32_t capacity_size;
+    uint32_t capacity_floating;
+
+    int64_t vertices_count;
+    int64_t arcs_count;
+
+};
+
+/**
+ * Binary graph file opened through a read-only memory mapping: the arrays are never parsed,
+ * the residual graph of a solver is filled with a bulk copy of each of them.
+ */
+template <typename Capacity>
+class GraphFile {
+
+    void* data;
+    size_t size;
+
+    const GraphFileHeader* header;
+    const int* first_arc;
+    const int* arc_head;
+    const int* arc_reverse;
+    const Capacity* arc_capacity;
+
+    static size_t align(size_t offset);
+
+    bool isValid() const;
+
+public:
+
+    GraphFile();
+
+    virtual ~GraphFile();
+
+    bool open(const char* file);
+
+    void close();
+
+    int getVerticesCount() const;
+
+    int getArcsCount() const;
+
+    void load(BaseGraph<Capacity>& graph) const;
+
+    static bool isGraphFile(const char* file);
+
+    static bool convert(const char* input, const char* output);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_GRAPH_FILE_H
\ No newline at end of file
@@ -0,0 +1,272 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <algorithm>
+#include "graph_reducer.h"
+
+/**
+ * Reduce the graph for a run between s and t. The arcs of the graph are built if needed, and the
+ * graph has to stay alive and unchanged until the cut of the reduced graph has been expanded.
+ * @param graph the original graph.
+ * @param s the source vertex.
+ * @param t the sink vertex.
+ */
+template <typename Capacity>
+GraphReducer<Capacity>::GraphReducer(BaseGraph<Capacity> &graph, int s, int t) : graph(graph), builder(0) {
+    if (!graph.arcs_built) {
+        graph.buildArcs();
+    }
+    this->source = s;
+    this->sink = t;
+    findCore();
+    int n = (int) graph.vertices.size();
+    // a vertex of the core is part of a chain when it has one arc entering it and one leaving
+    // it towards another vertex, and no other arc with some capacity inside the core
+    std::vector<bool> in_chain(n, false);
+    std::vector<int> chain_arc(n, -1);
+    for (int v = 0; v < n; v++) {
+        if (!this->in_core[v] || v == s || v == t) {
+            continue;
+        }
+        int in_count = 0, out_count = 0, tail = -1;
+        for (int arc = graph.first_arc[v]; arc < graph.first_arc[v + 1]; arc++) {
+            int i = graph.arc_head[arc];
+            if (i == v || !this->in_core[i]) {
+                continue;
+            }
+            if (graph.isPositive(graph.arc_capacity[arc])) {
+                out_count += 1;
+                chain_arc[v] = arc;
+            }
+            if (graph.isPositive(graph.arc_capacity[graph.arc_reverse[arc]])) {
+                in_count += 1;
+                tail = i;
+            }
+        }
+        in_chain[v] = in_count == 1 && out_count == 1 && graph.arc_head[chain_arc[v]] != tail;
+    }
+    this->reduced_id.assign(n, -1);
+    for (int v = 0; v < n; v++) {
+        if (this->in_core[v] && !in_chain[v]) {
+            this->reduced_id[v] = (int) this->original_id.size();
+            this->original_id.push_back(v);
+        }
+    }
+    this->builder = GraphBuilder<Capacity>((int) this->original_id.size());
+    this->chain_first.push_back(0);
+    this->chain_capacity_first.push_back(0);
+    for (int u : this->original_id) {
+        for (int arc = graph.first_arc[u]; arc < graph.first_arc[u + 1]; arc++) {
+            int v = graph.arc_head[arc];
+            if (v == u || !this->in_core[v] || !graph.isPositive(graph.arc_capacity[arc])) {
+                continue;
+            }
+            if (!in_chain[v]) {
+                this->builder.addEdge(this->reduced_id[u], this->reduced_id[v], graph.arc_capacity[arc]);
+                continue;
+            }
+            Capacity bottleneck;
+            int head = contractChain(u, arc, in_chain, chain_arc, bottleneck);
+            // a chain going back to its own tail carries no flow
+            if (head != u) {
+                this->builder.addEdge(this->reduced_id[u], this->reduced_id[head], bottleneck);
+            }
+        }
+    }
+}
+
+/**
+ * Mark the vertices that can be reached from the source and can reach the sink, with a forward
+ * and a backward breadth-first search on the arcs with some capacity. The source and the sink
+ * are always kept, even when there is no path between them.
+ */
+template <typename Capacity>
+void GraphReducer<Capacity>::findCore() {
+    int n = (int) this->graph.vertices.size();
+    std::vector<bool> from_source(n, false);
+    std::vector<int> queue(1, this->source);
+    from_source[this->source] = true;
+    for (int head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int arc = this->graph.first_arc[w]; arc < this->graph.first_arc[w + 1]; arc++) {
+            int i = this->graph.arc_head[arc];
+            if (!from_source[i] && this->graph.isPositive(this->graph.arc_capacity[arc])) {
+                from_source[i] = true;
+                queue.push_back(i);
+            }
+        }
+    }
+    std::vector<bool> to_sink(n, false);
+    queue.assign(1, this->sink);
+    to_sink[this->sink] = true;
+    for (int head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int arc = this->graph.first_arc[w]; arc < this->graph.first_arc[w + 1]; arc++) {
+            int i = this->graph.arc_head[arc];
+            if (!to_sink[i] && this->graph.isPositive(this->graph.arc_capacity[this->graph.arc_reverse[arc]])) {
+                to_sink[i] = true;
+                queue.push_back(i);
+            }
+        }
+    }
+    this->in_core.assign(n, false);
+    for (int v = 0; v < n; v++) {
+        this->in_core[v] = from_source[v] && to_sink[v];
+    }
+    this->in_core[this->source] = true;
+    this->in_core[this->sink] = true;
+}
+
+/**
+ * Follow a chain from the arc entering its first vertex to the first vertex not in a chain,
+ * storing its vertices and the capacities of its arcs.
+ * @param tail the vertex before the chain.
+ * @param arc the arc from the tail to the first vertex of the chain.
+ * @param in_chain the vertices that are part of a chain.
+ * @param chain_arc the only arc leaving each vertex of a chain.
+ * @param bottleneck set to the smallest capacity along the chain.
+ * @return the vertex after the chain.
+ */
+template <typename Capacity>
+int GraphReducer<Capacity>::contractChain(int tail, int arc, const std::vector<bool> &in_chain, const std::vector<int> &chain_arc, Capacity &bottleneck) {
+    int v = this->graph.arc_head[arc];
+    bottleneck = this->graph.arc_capacity[arc];
+    this->chain_capacities.push_back(bottleneck);
+    // every vertex of a chain is entered only by its predecessor, so the walk cannot loop
+    while (in_chain[v]) {
+        this->chain_vertices.push_back(v);
+        arc = chain_arc[v];
+        this->chain_capacities.push_back(this->graph.arc_capacity[arc]);
+        bottleneck = std::min(bottleneck, this->graph.arc_capacity[arc]);
+        v = this->graph.arc_head[arc];
+    }
+    this->chain_tail.push_back(tail);
+    this->chain_head.push_back(v);
+    this->chain_first.push_back((int) this->chain_vertices.size());
+    this->chain_capacity_first.push_back((int) this->chain_capacities.size());
+    return v;
+}
+
+/**
+ * @return the number of vertices of the reduced graph.
+ */
+template <typename Capacity>
+int GraphReducer<Capacity>::getVerticesCount() const {
+    return (int) this->original_id.size();
+}
+
+template <typename Capacity>
+int GraphReducer<Capacity>::getOriginalVerticesCount() const {
+    return (int) this->reduced_id.size();
+}
+
+/**
+ * @return the number of edges of the reduced graph, before the parallel ones are merged.
+ */
+template <typename Capacity>
+long GraphReducer<Capacity>::getArcsCount() const {
+    return (long) this->builder.getEdgesCount();
+}
+
+template <typename Capacity>
+int GraphReducer<Capacity>::getSource() const {
+    return this->source;
+}
+
+template <typename Capacity>
+int GraphReducer<Capacity>::getSink() const {
+    return this->sink;
+}
+
+/**
+ * @param v a vertex of the original graph.
+ * @return its id in the reduced graph, -1 if it has been removed.
+ */
+template <typename Capacity>
+int GraphReducer<Capacity>::getReducedVertex(int v) const {
+    return this->reduced_id[v];
+}
+
+/**
+ * Load the reduced graph into an empty one.
+ * @param target a graph with getVerticesCount() vertices.
+ */
+template <typename Capacity>
+void GraphReducer<Capacity>::load(BaseGraph<Capacity> &target) {
+    this->builder.build(target);
+}
+
+/**
+ * Turn a minimum cut of the reduced graph into one of the original graph. As in the cut of the
+ * graphs, the sink side is made of the vertices that can still reach the sink in the residual
+ * graph, and the arcs and the value of the cut are computed on the original arcs.
+ * @param reduced_cut the minimum cut of the reduced graph.
+ * @return the minimum cut of the original graph, with the same value.
+ */
+template <typename Capacity>
+MinimumCut<Capacity> GraphReducer<Capacity>::expandCut(const MinimumCut<Capacity> &reduced_cut) const {
+    int n = (int) this->graph.vertices.size();
+    std::vector<bool> sink_side(n, false);
+    for (int v : this->original_id) {
+        sink_side[v] = true;
+    }
+    for (int v : reduced_cut.source_side) {
+        sink_side[this->original_id[v]] = false;
+    }
+    for (int c = 0; c < this->chain_tail.size(); c++) {
+        bool tail_side = sink_side[this->chain_tail[c]];
+        bool head_side = sink_side[this->chain_head[c]];
+        int first = this->chain_first[c];
+        int length = this->chain_first[c + 1] - first;
+        // the vertices after the last saturated arc can still reach the head, the others reach
+        // the tail through the reverse arcs. Without a saturated arc the chain stays on one side
+        int split = tail_side && head_side ? 0 : length;
+        if (!tail_side && head_side) {
+            const Capacity *capacities = &this->chain_capacities[this->chain_capacity_first[c]];
+            Capacity bottleneck = *std::min_element(capacities, capacities + length + 1);
+            for (int k = 0; k <= length; k++) {
+                if (capacities[k] == bottleneck) {
+                    split = k;
+                }
+            }
+        }
+        for (int k = 0; k < length; k++) {
+            sink_side[this->chain_vertices[first + k]] = k >= split;
+        }
+    }
+    // no flow goes through the vertices outside the core, so their residual arcs are the original
+    // ones and they reach the sink only through a vertex of the core on the sink side
+    std::vector<int> queue;
+    for (int v = 0; v < n; v++) {
+        if (sink_side[v]) {
+            queue.push_back(v);
+        }
+    }
+    for (int head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int arc = this->graph.first_arc[w]; arc < this->graph.first_arc[w + 1]; arc++) {
+            int i = this->graph.arc_head[arc];
+            if (!sink_side[i] && !this->in_core[i] && this->graph.isPositive(this->graph.arc_capacity[this->graph.arc_reverse[arc]])) {
+                sink_side[i] = true;
+                queue.push_back(i);
+            }
+        }
+    }
+    MinimumCut<Capacity> cut;
+    cut.value = 0;
+    for (int i = 0; i < n; i++) {
+        if (sink_side[i]) {
+            continue;
+        }
+        cut.source_side.push_back(i);
+        for (int arc = this->graph.first_arc[i]; arc < this->graph.first_arc[i + 1]; arc++) {
+            if (this->graph.arc_capacity[arc] > 0 && sink_side[this->graph.arc_head[arc]]) {
+                cut.arcs.emplace_back(i, this->graph.arc_head[arc], this->graph.arc_capacity[arc]);
+                cut.value += this->graph.arc_capacity[arc];
+            }
+        }
+    }
+    return cut;
+}
+
+INSTANTIATE_FOR_CAPACITIES(GraphReducer)
\ No newline at end of file
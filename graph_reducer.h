@@ -0,0 +1,73 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_GRAPH_REDUCER_H
+#define ADVANCEDALGORITHMSPROJECT_GRAPH_REDUCER_H
+
+#include <vector>
+#include "base_graph.h"
+#include "graph_builder.h"
+
+/**
+ * Smaller graph with the same maximum flow between a source and a sink. Only the core of the
+ * graph is kept, the vertices that can be reached from the source and can reach the sink, since
+ * no flow goes through the others. The vertices of the core with a single arc entering them and
+ * a single one leaving them form chains, and each chain is replaced by one arc with the smallest
+ * capacity found along it. The arcs without capacity are dropped.
+ *
+ * A minimum cut of the reduced graph is expanded back to the original vertices: the chains are
+ * split at their last saturated arc and the vertices outside the core join the side they would
+ * have with the flow of the reduced graph, which never goes through them.
+ */
+template <typename Capacity>
+class GraphReducer {
+
+    const BaseGraph<Capacity> &graph;
+
+    int source;
+    int sink;
+
+    // id of each vertex in the reduced graph, -1 if it has been removed
+    std::vector<int> reduced_id;
+    std::vector<int> original_id;
+
+    std::vector<bool> in_core;
+
+    // the vertices of each chain, in order from its tail to its head, and the capacities of
+    // the arcs entering each of them followed by the one entering the head
+    std::vector<int> chain_tail;
+    std::vector<int> chain_head;
+    std::vector<int> chain_first;
+    std::vector<int> chain_vertices;
+    std::vector<int> chain_capacity_first;
+    std::vector<Capacity> chain_capacities;
+
+    GraphBuilder<Capacity> builder;
+
+    void findCore();
+
+    int contractChain(int tail, int arc, const std::vector<bool> &in_chain, const std::vector<int> &chain_arc, Capacity &bottleneck);
+
+public:
+
+    GraphReducer(BaseGraph<Capacity> &graph, int s, int t);
+
+    int getVerticesCount() const;
+
+    int getOriginalVerticesCount() const;
+
+    long getArcsCount() const;
+
+    int getSource() const;
+
+    int getSink() const;
+
+    int getReducedVertex(int v) const;
+
+    void load(BaseGraph<Capacity> &target);
+
+    MinimumCut<Capacity> expandCut(const MinimumCut<Capacity> &reduced_cut) const;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_GRAPH_REDUCER_H
\ No newline at end of file
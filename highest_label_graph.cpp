@@ -0,0 +1,133 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include "highest_label_graph.h"
+#include "push_relabel_graph_impl.h"
+
+/**
+ * The labels of the vertices never exceed 2 * V - 1, so one bucket for each
+ * possible label is enough to keep track of all the active vertices.
+ * @param vertices_count size of the graph.
+ */
+template <typename Capacity, typename Statistics>
+HighestLabelGraph<Capacity, Statistics>::HighestLabelGraph(int vertices_count) : Base(vertices_count) {
+    this->bucket_head.assign(2 * vertices_count, NO_VERTEX);
+    this->next_active.assign(vertices_count, NO_VERTEX);
+    this->previous_active.assign(vertices_count, NO_VERTEX);
+    this->bucket_label.assign(vertices_count, NO_VERTEX);
+    this->max_active_label = -1;
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::insertActive(int v) {
+    int label = this->vertices[v].label;
+    // the vertex is placed in front of the bucket of its label
+    this->previous_active[v] = NO_VERTEX;
+    this->next_active[v] = this->bucket_head[label];
+    if (this->bucket_head[label] != NO_VERTEX) {
+        this->previous_active[this->bucket_head[label]] = v;
+    }
+    this->bucket_head[label] = v;
+    this->bucket_label[v] = label;
+    if (label > this->max_active_label) {
+        this->max_active_label = label;
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::removeActive(int v) {
+    // unlink the vertex from the bucket it has been inserted in
+    if (this->previous_active[v] != NO_VERTEX) {
+        this->next_active[this->previous_active[v]] = this->next_active[v];
+    } else {
+        this->bucket_head[this->bucket_label[v]] = this->next_active[v];
+    }
+    if (this->next_active[v] != NO_VERTEX) {
+        this->previous_active[this->next_active[v]] = this->previous_active[v];
+    }
+    this->bucket_label[v] = NO_VERTEX;
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::activate(int v) {
+    // a warm start may activate a vertex that is already in its bucket
+    if (this->bucket_label[v] == NO_VERTEX) {
+        insertActive(v);
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::onLabelsUpdated() {
+    // the active vertices must be moved in the buckets of their new labels
+    for (int v = 0; v < this->vertices.size(); v++) {
+        if (this->bucket_label[v] != NO_VERTEX) {
+            removeActive(v);
+            insertActive(v);
+        }
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::printCurrentStatus() {
+    Base::printCurrentStatus();
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "  B = { ";
+        for (int label = this->max_active_label; label >= 0; label--) {
+            for (int v = this->bucket_head[label]; v != NO_VERTEX; v = this->next_active[v]) {
+                std::cout << v << ":" << label << " ";
+            }
+        }
+        std::cout << "}" << std::endl;
+    }
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::preProcess(int s, int t) {
+    // empty all the buckets before the source saturates its arcs
+    for (int &head : this->bucket_head) {
+        head = NO_VERTEX;
+    }
+    for (int &label : this->bucket_label) {
+        label = NO_VERTEX;
+    }
+    this->max_active_label = -1;
+    Base::preProcess(s, t);
+}
+
+template <typename Capacity, typename Statistics>
+int HighestLabelGraph<Capacity, Statistics>::getActiveNode(int s, int t) {
+    // during the first phase only the vertices below V can still reach the sink
+    auto limit = (int) (this->phase_one_only ? this->vertices.size() - 1 : this->bucket_head.size() - 1);
+    if (this->max_active_label > limit) {
+        this->max_active_label = limit;
+    }
+    // skip the empty buckets on top, the pointer only moves up when a vertex is inserted
+    while (this->max_active_label >= 0 && this->bucket_head[this->max_active_label] == NO_VERTEX) {
+        this->max_active_label -= 1;
+    }
+    if (this->max_active_label < 0) {
+        return NO_ACTIVE_NODE_FOUND;
+    }
+    return this->bucket_head[this->max_active_label];
+}
+
+template <typename Capacity, typename Statistics>
+void HighestLabelGraph<Capacity, Statistics>::discharge(int u) {
+    Base::discharge(u);
+    if (!this->isPositive(this->vertices[u].excess)) {
+        // all the excess has been moved away, the vertex is no more active
+        removeActive(u);
+    }
+}
+
+template <typename Capacity, typename Statistics>
+bool HighestLabelGraph<Capacity, Statistics>::relabel(int u) {
+    // the vertex must be moved in the bucket of its new label
+    removeActive(u);
+    bool relabeled = Base::relabel(u);
+    insertActive(u);
+    return relabeled;
+}
+
+INSTANTIATE_PUSH_RELABEL_GRAPH(HighestLabelGraph)
\ No newline at end of file
@@ -0,0 +1,57 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_HIGHEST_LABEL_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_HIGHEST_LABEL_GRAPH_H
+
+#include "push_relabel_graph.h"
+
+#define NO_VERTEX (-1)
+
+template <typename Capacity, typename Statistics = NoStatistics>
+class HighestLabelGraph final : public PushRelabelGraph<Capacity, Statistics, HighestLabelGraph<Capacity, Statistics>> {
+
+    typedef PushRelabelGraph<Capacity, Statistics, HighestLabelGraph<Capacity, Statistics>> Base;
+
+    // the main loop calls the hooks of the selection rule directly
+    friend Base;
+
+    // the active vertices are kept in buckets indexed by label: each bucket is
+    // an intrusive doubly linked list built on top of the next/previous arrays.
+    std::vector<int> bucket_head;
+    std::vector<int> next_active;
+    std::vector<int> previous_active;
+
+    // label of the bucket that contains the vertex, or NO_VERTEX if it is not active
+    std::vector<int> bucket_label;
+
+    // no bucket above this label contains an active vertex
+    int max_active_label;
+
+    void insertActive(int v);
+
+    void removeActive(int v);
+
+protected:
+
+    void activate(int v);
+
+    void onLabelsUpdated();
+
+public:
+
+    explicit HighestLabelGraph(int vertices_count);
+
+    void printCurrentStatus() override;
+
+    void preProcess(int s, int t);
+
+    int getActiveNode(int s, int t);
+
+    void discharge(int u);
+
+    bool relabel(int u);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_HIGHEST_LABEL_GRAPH_H
\ No newline at end of file
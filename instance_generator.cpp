@@ -0,0 +1,214 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <cmath>
+#include <algorithm>
+#include "instance_generator.h"
+
+// capacity used for the arcs that must never limit the flow
+#define LARGE_CAPACITY 1000000
+
+template <typename Capacity>
+InstanceGenerator<Capacity>::InstanceGenerator(uint64_t seed) {
+    this->rng.seed(seed);
+}
+
+template <typename Capacity>
+Capacity InstanceGenerator<Capacity>::randomCapacity(int64_t minimum, int64_t maximum) {
+    std::uniform_int_distribution<int64_t> distribution(minimum, maximum);
+    return (Capacity) distribution(this->rng);
+}
+
+template <typename Capacity>
+int InstanceGenerator<Capacity>::randomVertex(int begin, int end) {
+    std::uniform_int_distribution<int> distribution(begin, end - 1);
+    return distribution(this->rng);
+}
+
+/**
+ * Generate an instance of one of the families returned by getFamilies().
+ * @param family name of the family.
+ * @param size approximate number of vertices.
+ * @return the generated instance.
+ */
+template <typename Capacity>
+Instance<Capacity> InstanceGenerator<Capacity>::generate(const std::string &family, int size) {
+    if (family == "grid") {
+        return generateGrid(size);
+    } else if (family == "ak") {
+        return generateAK(size);
+    } else if (family == "genrmf") {
+        return generateGenrmf(size);
+    } else if (family == "bipartite") {
+        return generateBipartite(size);
+    }
+    return generateRandom(size);
+}
+
+/**
+ * Washington random level graph: a square grid whose columns are the levels, every vertex has
+ * arcs to three random vertices of the next column, the source feeds the whole first column and
+ * the whole last column drains into the sink.
+ */
+template <typename Capacity>
+Instance<Capacity> InstanceGenerator<Capacity>::generateGrid(int size) {
+    int side = std::max(2, (int) std::sqrt((double) size));
+    Instance<Capacity> instance;
+    instance.family = "grid";
+    instance.vertices_count = side * side + 2;
+    instance.source = side * side;
+    instance.sink = side * side + 1;
+    for (int row = 0; row < side; row++) {
+        instance.edges.emplace_back(instance.source, row, (Capacity) LARGE_CAPACITY);
+        instance.edges.emplace_back((side - 1) * side + row, instance.sink, (Capacity) LARGE_CAPACITY);
+    }
+    for (int column = 0; column + 1 < side; column++) {
+        for (int row = 0; row < side; row++) {
+            for (int i = 0; i < 3; i++) {
+                int head = (column + 1) * side + randomVertex(0, side);
+                instance.edges.emplace_back(column * side + row, head, randomCapacity(1, 10000));
+            }
+        }
+    }
+    return instance;
+}
+
+/**
+ * Deterministic network in the style of the AK generator, made of two long paths that force
+ * push-relabel to move the excess one vertex at a time. In the first path the capacities
+ * decrease and every vertex has a unit arc to the sink. The second path has large capacities
+ * and its vertices share a single exit towards the sink, so most of the flow entering it has to
+ * be returned to the source.
+ */
+template <typename Capacity>
+Instance<Capacity> InstanceGenerator<Capacity>::generateAK(int size) {
+    int k = std::max(2, (size - 3) / 2);
+    Instance<Capacity> instance;
+    instance.family = "ak";
+    instance.vertices_count = 2 * k + 3;
+    instance.source = 0;
+    instance.sink = 2 * k + 2;
+    int exit = 2 * k + 1;
+    // first part: vertices 1..k
+    instance.edges.emplace_back(instance.source, 1, (Capacity) k);
+    for (int i = 1; i <= k; i++) {
+        if (i < k) {
+            instance.edges.emplace_back(i, i + 1, (Capacity) (k - i));
+        }
+        instance.edges.emplace_back(i, instance.sink, (Capacity) 1);
+    }
+    // second part: vertices k+1..2k sharing the exit vertex
+    instance.edges.emplace_back(instance.source, k + 1, (Capacity) LARGE_CAPACITY);
+    for (int i = k + 1; i <= 2 * k; i++) {
+        if (i < 2 * k) {
+            instance.edges.emplace_back(i, i + 1, (Capacity) LARGE_CAPACITY);
+        }
+        instance.edges.emplace_back(i, exit, (Capacity) 1);
+    }
+    instance.edges.emplace_back(exit, instance.sink, (Capacity) k);
+    return instance;
+}
+
+/**
+ * Genrmf: a sequence of b square frames of a x a vertices. The vertices of a frame form a grid
+ * with arcs of large capacity in both directions, while consecutive frames are connected by a
+ * random permutation with capacities between 1 and 100. The source is the first vertex of the
+ * first frame and the sink is the last vertex of the last frame. The frames are twice as many
+ * as the vertices of a side, as in the "long" instances.
+ */
+template <typename Capacity>
+Instance<Capacity> InstanceGenerator<Capacity>::generateGenrmf(int size) {
+    int a = std::max(2, (int) std::round(std::cbrt(size / 2.0)));
+    int b = 2 * a;
+    int frame = a * a;
+    Instance<Capacity> instance;
+    instance.family = "genrmf";
+    instance.vertices_count = frame * b;
+    instance.source = 0;
+    instance.sink = frame * b - 1;
+    auto inside = (Capacity) (100 * frame);
+    std::vector<int> permutation(frame);
+    for (int f = 0; f < b; f++) {
+        int base = f * frame;
+        for (int row = 0; row < a; row++) {
+            for (int column = 0; column < a; column++) {
+                int v = base + row * a + column;
+                if (column + 1 < a) {
+                    instance.edges.emplace_back(v, v + 1, inside);
+                    instance.edges.emplace_back(v + 1, v, inside);
+                }
+                if (row + 1 < a) {
+                    instance.edges.emplace_back(v, v + a, inside);
+                    instance.edges.emplace_back(v + a, v, inside);
+                }
+            }
+        }
+        if (f + 1 < b) {
+            for (int i = 0; i < frame; i++) {
+                permutation[i] = i;
+            }
+            std::shuffle(permutation.begin(), permutation.end(), this->rng);
+            for (int i = 0; i < frame; i++) {
+                instance.edges.emplace_back(base + i, base + frame + permutation[i], randomCapacity(1, 100));
+            }
+        }
+    }
+    return instance;
+}
+
+/**
+ * Sparse random graph with eight arcs per vertex on average and capacities between 1 and 100.
+ */
+template <typename Capacity>
+Instance<Capacity> InstanceGenerator<Capacity>::generateRandom(int size) {
+    int n = std::max(2, size);
+    Instance<Capacity> instance;
+    instance.family = "random";
+    instance.vertices_count = n;
+    instance.source = 0;
+    instance.sink = n - 1;
+    for (long i = 0; i < 8L * n; i++) {
+        int u = randomVertex(0, n);
+        int v = randomVertex(0, n);
+        if (u != v) {
+            instance.edges.emplace_back(u, v, randomCapacity(1, 100));
+        }
+    }
+    return instance;
+}
+
+/**
+ * Bipartite matching-like network: the source feeds the left side, each left vertex has arcs to
+ * five random right vertices and the right side drains into the sink, all the capacities are
+ * between 1 and 100.
+ */
+template <typename Capacity>
+Instance<Capacity> InstanceGenerator<Capacity>::generateBipartite(int size) {
+    int side = std::max(1, (size - 2) / 2);
+    Instance<Capacity> instance;
+    instance.family = "bipartite";
+    instance.vertices_count = 2 * side + 2;
+    instance.source = 2 * side;
+    instance.sink = 2 * side + 1;
+    for (int i = 0; i < side; i++) {
+        instance.edges.emplace_back(instance.source, i, randomCapacity(1, 100));
+        instance.edges.emplace_back(side + i, instance.sink, randomCapacity(1, 100));
+        for (int j = 0; j < 5; j++) {
+            instance.edges.emplace_back(i, side + randomVertex(0, side), randomCapacity(1, 100));
+        }
+    }
+    return instance;
+}
+
+template <typename Capacity>
+bool InstanceGenerator<Capacity>::isFamily(const std::string &family) {
+    auto families = getFamilies();
+    return std::find(families.begin(), families.end(), family) != families.end();
+}
+
+template <typename Capacity>
+std::vector<std::string> InstanceGenerator<Capacity>::getFamilies() {
+    return {"grid", "ak", "genrmf", "random", "bipartite"};
+}
+
+INSTANTIATE_FOR_CAPACITIES(InstanceGenerator)
\ No newline at end of file
@@ -0,0 +1,64 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_INSTANCE_GENERATOR_H
+#define ADVANCEDALGORITHMSPROJECT_INSTANCE_GENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "base_graph.h"
+
+/**
+ * Maximum flow problem produced by a generator: the edges are meant to be added
+ * to a solver created with vertices_count vertices and solved from source to sink.
+ */
+template <typename Capacity>
+struct Instance {
+
+    std::string family;
+    int vertices_count;
+    int source;
+    int sink;
+    std::vector<Edge<Capacity>> edges;
+
+};
+
+/**
+ * Seeded generators for the classic families of maximum flow benchmarks. The same seed and
+ * size always produce the same instance, so timings can be compared between runs and solvers.
+ * The size is the approximate number of vertices of the generated graph.
+ */
+template <typename Capacity>
+class InstanceGenerator {
+
+    std::mt19937_64 rng;
+
+    Capacity randomCapacity(int64_t minimum, int64_t maximum);
+
+    int randomVertex(int begin, int end);
+
+public:
+
+    explicit InstanceGenerator(uint64_t seed);
+
+    Instance<Capacity> generate(const std::string &family, int size);
+
+    Instance<Capacity> generateGrid(int size);
+
+    Instance<Capacity> generateAK(int size);
+
+    Instance<Capacity> generateGenrmf(int size);
+
+    Instance<Capacity> generateRandom(int size);
+
+    Instance<Capacity> generateBipartite(int size);
+
+    static bool isFamily(const std::string &family);
+
+    static std::vector<std::string> getFamilies();
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_INSTANCE_GENERATOR_H
\ No newline at end of file
@@ -0,0 +1,394 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "job_server.h"
+
+/**
+ * Read a line from a socket, keeping what follows it for the next call.
+ * @param fd the socket.
+ * @param buffer the data read after the last line.
+ * @param line set to the next line, without the line feed.
+ * @return false at the end of the input.
+ */
+static bool readLine(int fd, std::string &buffer, std::string &line) {
+    while (true) {
+        size_t end = buffer.find('\n');
+        if (end != std::string::npos) {
+            line.assign(buffer, 0, end);
+            buffer.erase(0, end + 1);
+            return true;
+        }
+        char chunk[4096];
+        ssize_t count = read(fd, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            // the last line may not end with a line feed
+            line.swap(buffer);
+            buffer.clear();
+            return !line.empty();
+        }
+        buffer.append(chunk, (size_t) count);
+    }
+}
+
+template <typename Capacity>
+JobServer<Capacity>::Output::Output(std::ostream* stream) {
+    this->stream = stream;
+    this->fd = -1;
+}
+
+template <typename Capacity>
+JobServer<Capacity>::Output::Output(int fd) {
+    this->stream = nullptr;
+    this->fd = fd;
+}
+
+template <typename Capacity>
+JobServer<Capacity>::Output::~Output() {
+    if (this->fd >= 0) {
+        ::close(this->fd);
+    }
+}
+
+/**
+ * Write a result, the lines of the jobs running at the same time are never mixed.
+ * @param line the result, without the line feed.
+ */
+template <typename Capacity>
+void JobServer<Capacity>::Output::write(const std::string &line) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->stream != nullptr) {
+        *this->stream << line << std::endl;
+        return;
+    }
+    std::string data = line + "\n";
+    size_t written = 0;
+    while (written < data.size()) {
+        // a client that has gone away must not kill the server with a SIGPIPE
+        ssize_t count = send(this->fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return;
+        }
+        written += (size_t) count;
+    }
+}
+
+/**
+ * @param threads_count number of jobs solved at the same time, all the cores if not positive.
+ * @param cache_size number of graph files kept in memory.
+ * @param type the solver mode of the jobs that do not specify one.
+ */
+template <typename Capacity>
+JobServer<Capacity>::JobServer(int threads_count, size_t cache_size, SolverType type) : cache(cache_size) {
+    if (threads_count <= 0) {
+        threads_count = std::max(1, (int) std::thread::hardware_concurrency());
+    }
+    this->pool.reset(new ThreadPool(threads_count));
+    this->type = type;
+    this->global_relabel = false;
+    this->gap_heuristic = false;
+    this->reduction = false;
+    this->ordering = ORIGINAL_ORDER;
+    this->closed = false;
+    this->listener = -1;
+    this->stopped = false;
+}
+
+template <typename Capacity>
+void JobServer<Capacity>::setGlobalRelabel(bool enabled) {
+    this->global_relabel = enabled;
+}
+
+template <typename Capacity>
+void JobServer<Capacity>::setGapHeuristic(bool enabled) {
+    this->gap_heuristic = enabled;
+}
+
+template <typename Capacity>
+void JobServer<Capacity>::setReduction(bool enabled) {
+    this->reduction = enabled;
+}
+
+template <typename Capacity>
+void JobServer<Capacity>::setVertexOrdering(VertexOrdering ordering) {
+    this->ordering = ordering;
+}
+
+/**
+ * Read the jobs of a client and queue them, the invalid ones are answered at once.
+ * @param next_line reads the next line of the client, false at the end of its input.
+ * @param output where the results of the client are written.
+ * @return true if the client asked to stop the server.
+ */
+template <typename Capacity>
+bool JobServer<Capacity>::readJobs(const std::function<bool(std::string&)> &next_line, const std::shared_ptr<Output> &output) {
+    std::string line;
+    while (next_line(line)) {
+        std::istringstream words(line);
+        Job job;
+        std::string graph, source, sink, mode;
+        if (!(words >> job.id)) {
+            continue;
+        }
+        if (job.id == "quit") {
+            return true;
+        }
+        if (!(words >> graph >> source >> sink)) {
+            output->write(job.id + " error expected <id> <graph> <source> <sink> [mode]");
+            continue;
+        }
+        words >> mode;
+        std::string error;
+        try {
+            job.source = source == "-" ? -1 : std::stoi(source);
+            job.sink = sink == "-" ? -1 : std::stoi(sink);
+            job.type = mode.empty() ? this->type : mode == "auto" ? AUTO_SOLVER : (SolverType) std::stoi(mode);
+            if (job.type < GENERIC_SOLVER || job.type > AUTO_SOLVER) {
+                error = "invalid solver mode " + mode;
+            }
+        } catch (const std::exception &) {
+            error = "invalid source, sink or solver mode";
+        }
+        if (graph.compare(0, 7, "inline:") == 0) {
+            // the edges follow the job and are read even when it is not valid
+            long count = std::strtol(graph.c_str() + 7, nullptr, 10);
+            std::vector<Edge<Capacity>> edges;
+            for (long i = 0; i < count && next_line(line); i++) {
+                std::istringstream edge(line);
+                int u, v;
+                Capacity capacity;
+                if (edge >> u >> v >> capacity && u >= 0 && v >= 0) {
+                    edges.emplace_back(u, v, capacity);
+                }
+            }
+            if (count <= 0 || edges.size() != (size_t) count) {
+                error = error.empty() ? "invalid inline graph" : error;
+            }
+            job.graph = CachedGraph<Capacity>::fromEdges(std::move(edges));
+        } else {
+            job.path = graph;
+        }
+        if (!error.empty()) {
+            output->write(job.id + " error " + error);
+            continue;
+        }
+        job.output = output;
+        push(std::move(job));
+    }
+    return false;
+}
+
+template <typename Capacity>
+void JobServer<Capacity>::push(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back(std::move(job));
+    }
+    this->job_ready.notify_one();
+}
+
+/**
+ * Wait for the next job.
+ * @param job set to the job.
+ * @return false once the queue is closed and there are no jobs left.
+ */
+template <typename Capacity>
+bool JobServer<Capacity>::pop(Job &job) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->job_ready.wait(lock, [this]() {
+        return !this->jobs.empty() || this->closed;
+    });
+    if (this->jobs.empty()) {
+        return false;
+    }
+    job = std::move(this->jobs.front());
+    this->jobs.pop_front();
+    return true;
+}
+
+/**
+ * No more jobs will be queued, the workers stop after the ones already in the queue.
+ */
+template <typename Capacity>
+void JobServer<Capacity>::close() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->closed = true;
+    }
+    this->job_ready.notify_all();
+}
+
+template <typename Capacity>
+void JobServer<Capacity>::work() {
+    Job job;
+    while (pop(job)) {
+        execute(job);
+        // release the graph and the output of the job before waiting for the next one
+        job = Job();
+    }
+}
+
+/**
+ * Solve a job on a solver of its own, which uses a single thread since the other threads of the
+ * pool are solving the other jobs. The time covers the copy of the graph into the solver too.
+ * @param job the job to solve.
+ */
+template <typename Capacity>
+void JobServer<Capacity>::execute(const Job &job) {
+    // a malformed job only gets an error, it must not stop the jobs of the other clients
+    try {
+        std::string error;
+        std::shared_ptr<const CachedGraph<Capacity>> graph = job.graph != nullptr ? job.graph : this->cache.get(job.path, error);
+        if (graph == nullptr) {
+            job.output->write(job.id + " error " + error);
+            return;
+        }
+        int n = graph->vertices_count;
+        int s = job.source == -1 ? graph->source : job.source;
+        int t = job.sink == -1 ? graph->sink : job.sink;
+        if (s < 0 || t < 0 || s >= n || t >= n || s == t) {
+            job.output->write(job.id + " error invalid source or sink");
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        GoldbergProblemSolver<Capacity> solver(n, job.type, false);
+        solver.setGlobalRelabel(this->global_relabel);
+        solver.setGapHeuristic(this->gap_heuristic);
+        solver.setReduction(this->reduction);
+        solver.setVertexOrdering(this->ordering);
+        solver.setThreadCount(1);
+        graph->load(solver);
+        Capacity flow = solver.getMaximumFlow(s, t);
+        auto end = std::chrono::steady_clock::now();
+        std::ostringstream result;
+        result << job.id << " ok " << flow << " " << solver.getSolverType() << " "
+               << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        job.output->write(result.str());
+    } catch (const std::bad_alloc &) {
+        job.output->write(job.id + " error out of memory");
+    } catch (const std::exception &exception) {
+        job.output->write(job.id + " error " + exception.what());
+    }
+}
+
+/**
+ * Stop accepting clients and stop reading the open connections, whose results are still sent.
+ */
+template <typename Capacity>
+void JobServer<Capacity>::stop() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopped = true;
+    shutdown(this->listener, SHUT_RDWR);
+    for (int fd : this->connections) {
+        shutdown(fd, SHUT_RD);
+    }
+}
+
+/**
+ * Solve the jobs read from a stream until its end or a "quit" line, and wait for all of them.
+ * @param input the jobs.
+ * @param output the results.
+ */
+template <typename Capacity>
+void JobServer<Capacity>::serve(std::istream &input, std::ostream &output) {
+    std::shared_ptr<Output> results(new Output(&output));
+    this->closed = false;
+    std::thread reader([this, &input, results]() {
+        readJobs([&input](std::string &line) {
+            return (bool) std::getline(input, line);
+        }, results);
+        close();
+    });
+    this->pool->run([this](int thread_id) {
+        work();
+    });
+    reader.join();
+}
+
+/**
+ * Accept the clients on a Unix socket until one of them sends "quit". Each client is read by a
+ * thread of its own and receives the results of its jobs on the same connection.
+ * @param path path of the socket, replaced if it already exists.
+ * @return false if the socket cannot be created.
+ */
+template <typename Capacity>
+bool JobServer<Capacity>::serveSocket(const char* path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        std::cerr << "The socket path " << path << " is too long" << std::endl;
+        return false;
+    }
+    strcpy(address.sun_path, path);
+    this->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (this->listener < 0 || bind(this->listener, (sockaddr*) &address, sizeof(address)) != 0 || listen(this->listener, SOMAXCONN) != 0) {
+        std::cerr << "Unable to listen on the socket " << path << ": " << strerror(errno) << std::endl;
+        if (this->listener >= 0) {
+            ::close(this->listener);
+        }
+        return false;
+    }
+    this->closed = false;
+    this->stopped = false;
+    std::thread acceptor([this]() {
+        std::vector<std::thread> readers;
+        while (true) {
+            int fd = accept(this->listener, nullptr, nullptr);
+            if (fd < 0 && errno == EINTR) {
+                continue;
+            }
+            if (fd < 0) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                // a client accepted while the server was stopping is not read
+                if (this->stopped) {
+                    shutdown(fd, SHUT_RD);
+                }
+                this->connections.insert(fd);
+            }
+            readers.emplace_back([this, fd]() {
+                std::shared_ptr<Output> results(new Output(fd));
+                std::string buffer;
+                bool quit = readJobs([fd, &buffer](std::string &line) {
+                    return readLine(fd, buffer, line);
+                }, results);
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->connections.erase(fd);
+                }
+                if (quit) {
+                    stop();
+                }
+            });
+        }
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        close();
+    });
+    this->pool->run([this](int thread_id) {
+        work();
+    });
+    acceptor.join();
+    ::close(this->listener);
+    unlink(path);
+    return true;
+}
+
+INSTANTIATE_FOR_CAPACITIES(JobServer)
\ No newline at end of file
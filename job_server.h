@@ -0,0 +1,119 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_JOB_SERVER_H
+#define ADVANCEDALGORITHMSPROJECT_JOB_SERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include "graph_cache.h"
+#include "thread_pool.h"
+
+/**
+ * Long running solver for many queries, which pay neither the start of the process nor the
+ * parsing of a graph they share with the previous ones. The jobs are read one per line, from
+ * the standard input or from the clients of a Unix socket:
+ *
+ *     <id> <graph> <source> <sink> [mode]
+ *
+ * The graph is the path of a text, DIMACS or binary file, or "inline:<n>" followed by n lines
+ * with the edges ("u v capacity"). The terminals can be "-" to take the ones of a DIMACS file,
+ * and the mode is a solver mode of the command line (0-8 or auto). A line with "quit" stops the
+ * server. The jobs run at the same time, one for each thread of the pool, and each result is
+ * written back to the client of the job as soon as it is ready, so not in the order of the jobs:
+ *
+ *     <id> ok <maximum flow> <solver mode> <time [ns]>
+ *     <id> error <message>
+ */
+template <typename Capacity>
+class JobServer {
+
+    // where the results of a client are written, closed when its last job is done
+    struct Output {
+
+        std::mutex mutex;
+        std::ostream* stream;
+        int fd;
+
+        explicit Output(std::ostream* stream);
+
+        explicit Output(int fd);
+
+        ~Output();
+
+        void write(const std::string &line);
+
+    };
+
+    struct Job {
+
+        std::string id;
+        std::string path;
+        std::shared_ptr<const CachedGraph<Capacity>> graph;
+        int source;
+        int sink;
+        SolverType type;
+        std::shared_ptr<Output> output;
+
+    };
+
+    GraphCache<Capacity> cache;
+
+    std::unique_ptr<ThreadPool> pool;
+
+    SolverType type;
+    bool global_relabel;
+    bool gap_heuristic;
+    bool reduction;
+    VertexOrdering ordering;
+
+    // jobs read and not started yet, the workers stop once the queue is closed and empty
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::deque<Job> jobs;
+    bool closed;
+
+    // socket accepting the clients and the connections still open, shut down by "quit"
+    int listener;
+    std::set<int> connections;
+    bool stopped;
+
+    bool readJobs(const std::function<bool(std::string&)> &next_line, const std::shared_ptr<Output> &output);
+
+    void push(Job job);
+
+    bool pop(Job &job);
+
+    void close();
+
+    void work();
+
+    void execute(const Job &job);
+
+    void stop();
+
+public:
+
+    JobServer(int threads_count, size_t cache_size, SolverType type);
+
+    void setGlobalRelabel(bool enabled);
+
+    void setGapHeuristic(bool enabled);
+
+    void setReduction(bool enabled);
+
+    void setVertexOrdering(VertexOrdering ordering);
+
+    void serve(std::istream &input, std::ostream &output);
+
+    bool serveSocket(const char* path);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_JOB_SERVER_H
\ No newline at end of file
@@ -2,44 +2,126 @@
 // Created by andrea on 09/09/18.
 //
 #include <iostream>
-#include <algorithm>
 #include "lift_to_front_graph.h"
+#include "push_relabel_graph_impl.h"
 
-void LiftToFrontGraph::printCurrentStatus() {
-    BaseGraph::printCurrentStatus();
-    if (this->verbose) {
+template <typename Capacity, typename Statistics>
+LiftToFrontGraph<Capacity, Statistics>::LiftToFrontGraph(int vertices_count) : Base(vertices_count) {
+    this->next_vertex.assign(vertices_count, NO_VERTEX);
+    this->previous_vertex.assign(vertices_count, NO_VERTEX);
+    this->list_head = NO_VERTEX;
+    this->cursor = NO_VERTEX;
+}
+
+/**
+ * Unlink the vertex from its position and link it again in front of L, in constant time.
+ * @param v index of the vertex.
+ */
+template <typename Capacity, typename Statistics>
+void LiftToFrontGraph<Capacity, Statistics>::moveToFront(int v) {
+    if (this->list_head == v) {
+        return;
+    }
+    this->next_vertex[this->previous_vertex[v]] = this->next_vertex[v];
+    if (this->next_vertex[v] != NO_VERTEX) {
+        this->previous_vertex[this->next_vertex[v]] = this->previous_vertex[v];
+    }
+    this->previous_vertex[v] = NO_VERTEX;
+    this->next_vertex[v] = this->list_head;
+    this->previous_vertex[this->list_head] = v;
+    this->list_head = v;
+}
+
+template <typename Capacity, typename Statistics>
+void LiftToFrontGraph<Capacity, Statistics>::printCurrentStatus() {
+    Base::printCurrentStatus();
+    if (Statistics::enabled && this->verbose) {
         std::cout << "  L = { ";
-        for (int &index : this->list) {
-            std::cout << index << " ";
+        for (int v = this->list_head; v != NO_VERTEX; v = this->next_vertex[v]) {
+            std::cout << v << (v == this->cursor ? "* " : " ");
         }
         std::cout << "}" << std::endl;
     }
 }
 
-void LiftToFrontGraph::preProcess(int s, int t) {
-    BaseGraph::preProcess(s, t);
+template <typename Capacity, typename Statistics>
+void LiftToFrontGraph<Capacity, Statistics>::preProcess(int s, int t) {
+    Base::preProcess(s, t);
+    // all the vertices have the same label, so any order is topological
+    this->list_head = NO_VERTEX;
+    int last = NO_VERTEX;
     for (int i = 0; i < this->vertices.size(); i++) {
-        if (i != s && i != t) {
-            this->list.push_back(i);
+        if (i == s || i == t) {
+            continue;
+        }
+        this->previous_vertex[i] = last;
+        this->next_vertex[i] = NO_VERTEX;
+        if (last == NO_VERTEX) {
+            this->list_head = i;
+        } else {
+            this->next_vertex[last] = i;
         }
+        last = i;
     }
+    this->cursor = this->list_head;
 }
 
-int LiftToFrontGraph::getActiveNode(int s, int t) {
-    for (int index : this->list) {
-        if (this->vertices[index].excess > 0) {
-            return index;
+/**
+ * Continue the scan of L from the cursor. The pushes only go forward in L, so the vertices
+ * before the cursor are inactive; they are checked again only when the end of L is reached,
+ * which covers the vertices activated by a warm start.
+ * @return the first active vertex from the cursor on.
+ */
+template <typename Capacity, typename Statistics>
+int LiftToFrontGraph<Capacity, Statistics>::getActiveNode(int s, int t) {
+    for (int v = this->cursor; v != NO_VERTEX; v = this->next_vertex[v]) {
+        if (this->isActive(v)) {
+            this->cursor = v;
+            return v;
+        }
+    }
+    for (int v = this->list_head; v != this->cursor && v != NO_VERTEX; v = this->next_vertex[v]) {
+        if (this->isActive(v)) {
+            this->cursor = v;
+            return v;
         }
     }
     return NO_ACTIVE_NODE_FOUND;
 }
 
-bool LiftToFrontGraph::relabel(int u) {
-    bool relabeled = BaseGraph::relabel(u);
-    if (relabeled && this->list[0] != u) {
-        // the vertex u must be placed in front of the list L
-        auto it = std::find(this->list.begin(), this->list.end(), u);
-        std::rotate(this->list.begin(), it, it + 1);
+template <typename Capacity, typename Statistics>
+void LiftToFrontGraph<Capacity, Statistics>::onLabelsUpdated() {
+    // admissible arcs go from a label to the one just below it, so sorting by decreasing
+    // label gives a topological order again: a counting sort keeps the current order of ties
+    int limit = 2 * (int) this->vertices.size();
+    std::vector<int> start(limit + 2, 0);
+    for (int v = this->list_head; v != NO_VERTEX; v = this->next_vertex[v]) {
+        start[limit - this->vertices[v].label + 1] += 1;
+    }
+    for (int k = 0; k <= limit; k++) {
+        start[k + 1] += start[k];
+    }
+    std::vector<int> order(start[limit + 1]);
+    for (int v = this->list_head; v != NO_VERTEX; v = this->next_vertex[v]) {
+        order[start[limit - this->vertices[v].label]++] = v;
+    }
+    this->list_head = order.empty() ? NO_VERTEX : order[0];
+    for (int k = 0; k < order.size(); k++) {
+        this->previous_vertex[order[k]] = k > 0 ? order[k - 1] : NO_VERTEX;
+        this->next_vertex[order[k]] = k + 1 < order.size() ? order[k + 1] : NO_VERTEX;
+    }
+    this->cursor = this->list_head;
+}
+
+template <typename Capacity, typename Statistics>
+bool LiftToFrontGraph<Capacity, Statistics>::relabel(int u) {
+    bool relabeled = Base::relabel(u);
+    if (relabeled) {
+        // the vertex u must be placed in front of the list L, the scan goes on after it
+        moveToFront(u);
+        this->cursor = u;
     }
     return relabeled;
-}
\ No newline at end of file
+}
+
+INSTANTIATE_PUSH_RELABEL_GRAPH(LiftToFrontGraph)
\ No newline at end of file
@@ -5,23 +5,48 @@
 #ifndef ADVANCEDALGORITHMSPROJECT_LIFT_TO_FRONT_GRAPH_H
 #define ADVANCEDALGORITHMSPROJECT_LIFT_TO_FRONT_GRAPH_H
 
-#include "base_graph.h"
+#include "push_relabel_graph.h"
 
-class LiftToFrontGraph : public BaseGraph {
+#define NO_VERTEX (-1)
 
-    std::vector<int> list;
+/**
+ * Relabel-to-front: the vertices other than the source and the sink are kept in a list L in
+ * topological order of the admissible arcs. The list is scanned once from a cursor, and a vertex
+ * that is relabeled moves to the front of L while the scan continues right after it.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class LiftToFrontGraph final : public PushRelabelGraph<Capacity, Statistics, LiftToFrontGraph<Capacity, Statistics>> {
+
+    typedef PushRelabelGraph<Capacity, Statistics, LiftToFrontGraph<Capacity, Statistics>> Base;
+
+    // the main loop calls the hooks of the selection rule directly
+    friend Base;
+
+    // the list L is an intrusive doubly linked list built on top of the next/previous arrays
+    std::vector<int> next_vertex;
+    std::vector<int> previous_vertex;
+    int list_head;
+
+    // vertex of L being discharged, the scan for active vertices resumes from it
+    int cursor;
+
+    void moveToFront(int v);
+
+protected:
+
+    void onLabelsUpdated();
 
 public:
 
-    explicit LiftToFrontGraph(int vertices_count) : BaseGraph(vertices_count) {}
+    explicit LiftToFrontGraph(int vertices_count);
 
     void printCurrentStatus() override;
 
-    void preProcess(int s, int t) override;
+    void preProcess(int s, int t);
 
-    int getActiveNode(int s, int t) override;
+    int getActiveNode(int s, int t);
 
-    bool relabel(int u) override;
+    bool relabel(int u);
 };
 
 #endif //ADVANCEDALGORITHMSPROJECT_LIFT_TO_FRONT_GRAPH_H
\ No newline at end of file
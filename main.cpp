@@ -3,53 +3,97 @@
 #include <fstream>
 #include <chrono>
 #include <random>
+#include <thread>
 #include "goldberg_algorthm_solver.h"
 #include "lift_to_front_graph.h"
 #include "generic_graph.h"
+#include "parallel_graph.h"
+#include "dense_graph.h"
+#include "gomory_hu_tree.h"
+#include "job_server.h"
+#include "memory_tracker.h"
 
 #define MODE_GENERIC 0
 #define MODE_LIFT_TO_FRONT 1
+#define MODE_HIGHEST_LABEL 2
+#define MODE_PARALLEL 3
+#define MODE_FIFO 4
+#define MODE_DENSE 5
+#define MODE_BOYKOV_KOLMOGOROV 6
+#define MODE_DINIC 7
+#define MODE_EXCESS_SCALING 8
+#define MODE_AUTO 9
 #define DEBUG_MODE false
 #define RUN_TIMES 10
+#define DEFAULT_CACHE_SIZE 16
 
+template <typename Capacity>
 struct FileLine {
 
     int u;
     int v;
-    int capacity;
+    Capacity capacity;
 
-    FileLine(int u, int v, int capacity) {
+    FileLine(int u, int v, Capacity capacity) {
         this->u = u;
         this->v = v;
         this->capacity = capacity;
     }
 };
 
+/**
+ * Memory measured for one graph: the build phase creates the graph and adds the edges, the
+ * solve phase is the first run of the algorithm, which also builds the residual graph.
+ */
+struct MemoryResult {
+
+    MemoryUsage build;
+    MemoryUsage solve;
+
+};
+
 struct BenchmarkResult {
 
     int edge_count;
     long time_generic[RUN_TIMES];
-    long memory_generic;
+    MemoryResult memory_generic;
     long time_lift_to_front[RUN_TIMES];
-    long memory_lift_to_front;
-
-    BenchmarkResult(int edge_count, long time_generic[RUN_TIMES], long memory_generic, long time_lift_to_front[RUN_TIMES], long memory_lift_to_front) {
-        this->edge_count = edge_count;
-        for (int i = 0; i < RUN_TIMES; i++) {
-            this->time_generic[i] = time_generic[i];
-            this->time_lift_to_front[i] = time_lift_to_front[i];
-        }
-        this->memory_generic = memory_generic;
-        this->memory_lift_to_front = memory_lift_to_front;
-    }
+    MemoryResult memory_lift_to_front;
+    long time_parallel[RUN_TIMES];
+    MemoryResult memory_parallel;
+    long time_dense[RUN_TIMES];
+    MemoryResult memory_dense;
 
 };
 
-std::vector<FileLine> readGraphFromFile(char* file);
+template <typename Capacity>
+std::vector<FileLine<Capacity>> readGraphFromFile(char* file);
+
+BenchmarkResult execute_benchmark(int vertices, bool global_relabel, bool gap_heuristic, int threads);
+
+template <typename Graph>
+void benchmarkGraph(int vertices, const std::vector<Edge<int32_t>> &edges, bool global_relabel, bool gap_heuristic, int threads, long time[RUN_TIMES], MemoryResult &memory);
+
+void writeMemoryHeader(std::ofstream &output);
+
+void writeMemoryResult(std::ofstream &output, int vertices, int edge_count, const MemoryResult &memory);
 
-BenchmarkResult execute_benchmark(int vertices);
+template <typename Capacity>
+int getGraphVertexCount(const std::vector<FileLine<Capacity>> &lines);
 
-int getGraphVertexCount(std::vector<FileLine> lines);
+bool checkTerminals(int s, int t, int vertices_count);
+
+template <typename Capacity>
+bool solveGraphFromFile(char* file, int s, int t, SolverType type, bool verbose, bool statistics, bool global_relabel, bool gap_heuristic, int threads, bool cut, bool reduce, VertexOrdering ordering);
+
+template <typename Capacity>
+void solveGraph(GoldbergProblemSolver<Capacity> &solver, int s, int t, bool global_relabel, bool gap_heuristic, int threads, bool cut, bool reduce, VertexOrdering ordering, bool statistics);
+
+template <typename Capacity>
+bool buildCutTree(char* file, int s, int t, SolverType type, int threads);
+
+template <typename Capacity>
+bool runServer(char* socket_path, SolverType type, int threads, int cache_size, bool global_relabel, bool gap_heuristic, bool reduce, VertexOrdering ordering);
 
 int main(int argc, char* argv[]) {
     // basic parameters
@@ -60,6 +104,20 @@ int main(int argc, char* argv[]) {
     int s = -1;
     int t = -1;
     int m = 0;
+    bool g = false;
+    bool gap = false;
+    int p = 0;
+    bool cut = false;
+    bool stats = false;
+    bool tree = false;
+    bool reduce = false;
+    std::string order = "original";
+    std::string capacity_type = "int32";
+    char* convert = nullptr;
+    // server parameters
+    bool serve = false;
+    char* socket_path = nullptr;
+    int cache_size = DEFAULT_CACHE_SIZE;
     // benchmark parameters
     char* folder = nullptr;
     int min = 0;
@@ -80,11 +138,57 @@ int main(int argc, char* argv[]) {
             t = std::stoi(argv[i+1]);
         } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
             // the next argument should be the solver algorithm
-            m = std::stoi(argv[i+1]);
+            m = strcmp(argv[i+1], "auto") == 0 ? MODE_AUTO : std::stoi(argv[i+1]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            // the next argument should be the number of threads
+            p = std::stoi(argv[i+1]);
         } else if (strcmp(argv[i], "-v") == 0) {
             // this is a flag and it means that the solver must
             // be executed in verbose mode.
             v = true;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            // this is a flag and it means that the solver must
+            // periodically recompute the labels with a global relabel.
+            g = true;
+        } else if (strcmp(argv[i], "--gap") == 0) {
+            // this is a flag and it means that the solver must
+            // lift at once the vertices above an empty label.
+            gap = true;
+        } else if (strcmp(argv[i], "--cut") == 0) {
+            // this is a flag and it means that the minimum cut
+            // must be printed instead of the maximum flow only.
+            cut = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            // this is a flag and it means that the counters of the
+            // solver must be printed after the maximum flow.
+            stats = true;
+        } else if (strcmp(argv[i], "--tree") == 0) {
+            // this is a flag and it means that the minimum cuts between all the
+            // pairs of vertices must be computed, the edges are undirected.
+            tree = true;
+        } else if (strcmp(argv[i], "--reduce") == 0) {
+            // this is a flag and it means that the vertices that cannot carry
+            // flow must be removed and the chains contracted before solving.
+            reduce = true;
+        } else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            // the next argument should be the order of the vertices in memory
+            order = argv[i+1];
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            // the next argument should be the type used for the capacities
+            capacity_type = argv[i+1];
+        } else if (strcmp(argv[i], "--convert") == 0 && i + 1 < argc) {
+            // the next argument should be the binary graph file to write
+            convert = argv[i+1];
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            // this is a flag and it means that the jobs must be
+            // read from the standard input until its end.
+            serve = true;
+        } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            // the next argument should be the Unix socket of the server
+            socket_path = argv[i+1];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            // the next argument should be the number of graphs kept in memory
+            cache_size = std::stoi(argv[i+1]);
         } else if (strcmp(argv[i], "--test") == 0 && i + 2 < argc) {
             // this is the test mode, the user must specify the lower and upper bound
             test_mode = true;
@@ -93,9 +197,13 @@ int main(int argc, char* argv[]) {
         }
     }
     if (test_mode) {
+#ifndef MEMORY_TRACKER
+        std::cerr << "The test mode measures the heap with the memory tracker, run it from the AdvancedAlgorithmsTest build";
+        return 1;
+#endif
         // validate the parameters
         if (folder == nullptr) {
-            std::cerr << "Missing -o /path/to/destination argument. Usage: solver --test 1 100 -o /path/to/output/folder [-v to enable verbose mode]";
+            std::cerr << "Missing -o /path/to/destination argument. Usage: solver --test 1 100 -o /path/to/output/folder [-p threads] [-g to enable global relabel] [--gap to enable gap heuristic] [--cut to print the minimum cut] [--capacity int32 | int64 | double] [-v to enable verbose mode]";
             return 1;
         }
         // open both output files
@@ -106,25 +214,37 @@ int main(int argc, char* argv[]) {
         std::ofstream output_memory_generic(folder_name + "/output_memory_generic.txt");
         std::ofstream output_memory_lift_to_front(folder_name + "/output_memory_lift_to_front.txt");
         std::ofstream output_memory_difference(folder_name + "/output_memory_difference.txt");
+        std::ofstream output_time_parallel(folder_name + "/output_time_parallel.txt");
+        std::ofstream output_memory_parallel(folder_name + "/output_memory_parallel.txt");
+        std::ofstream output_time_dense(folder_name + "/output_time_dense.txt");
+        std::ofstream output_memory_dense(folder_name + "/output_memory_dense.txt");
         // write the header line in all files
         output_time_generic << "vertex_count, edge_count, min_time [ms], max_time [ms], avg_time [ms]";
         output_time_lift_to_front << "vertex_count, edge_count, min_time [ms], max_time [ms], avg_time [ms]";
         output_time_difference << "vertex_count, edge_count, min_time_diff [ms], max_time_diff [ms], avg_time_diff [ms]";
+        output_time_parallel << "vertex_count, edge_count, min_time [ms], max_time [ms], avg_time [ms]";
+        output_time_dense << "vertex_count, edge_count, min_time [ms], max_time [ms], avg_time [ms]";
         for (int i = 0; i < RUN_TIMES; i++) {
                 output_time_generic << ", time_diff_run_" << (i + 1) << " [ms]";
                 output_time_lift_to_front << ", time_diff_run_" << (i + 1) << " [ms]";
                 output_time_difference << ", time_diff_run_" << (i + 1) << " [ms]";
+                output_time_parallel << ", time_run_" << (i + 1) << " [ms]";
+                output_time_dense << ", time_run_" << (i + 1) << " [ms]";
         }
         output_time_generic << std::endl;
         output_time_lift_to_front << std::endl;
         output_time_difference << std::endl;
-        output_memory_generic << "vertex_count, edge_count, memory_used [bytes]" << std::endl;
-        output_memory_lift_to_front << "vertex_count, edge_count, memory_used [bytes]" << std::endl;
-        output_memory_difference << "vertex_count, edge_count, memory_diff [bytes]" << std::endl;
+        output_time_parallel << std::endl;
+        output_time_dense << std::endl;
+        writeMemoryHeader(output_memory_generic);
+        writeMemoryHeader(output_memory_lift_to_front);
+        writeMemoryHeader(output_memory_parallel);
+        writeMemoryHeader(output_memory_dense);
+        output_memory_difference << "vertex_count, edge_count, build_peak_diff [bytes], solve_peak_diff [bytes]" << std::endl;
         // execute all the tests
         for (int i = min; i <= max; i++) {
             // execute the benchmark
-            BenchmarkResult result = execute_benchmark(i);
+            BenchmarkResult result = execute_benchmark(i, g, gap, p);
             // calculate the min, max and average time for both results
             int min_time_generic = -1;
             int max_time_generic = 0;
@@ -135,6 +255,12 @@ int main(int argc, char* argv[]) {
             int min_time_difference = -1;
             int max_time_difference = 0;
             int avg_time_difference = 0;
+            long min_time_parallel = -1;
+            long max_time_parallel = 0;
+            long avg_time_parallel = 0;
+            long min_time_dense = -1;
+            long max_time_dense = 0;
+            long avg_time_dense = 0;
             for (int j = 0; j < RUN_TIMES; j++) {
                 if (min_time_generic == -1 || result.time_generic[j] < min_time_generic) {
                     min_time_generic = result.time_generic[j];
@@ -158,30 +284,56 @@ int main(int argc, char* argv[]) {
                     max_time_difference = time_difference;
                 }
                 avg_time_difference += time_difference;
+                if (min_time_parallel == -1 || result.time_parallel[j] < min_time_parallel) {
+                    min_time_parallel = result.time_parallel[j];
+                }
+                if (result.time_parallel[j] > max_time_parallel) {
+                    max_time_parallel = result.time_parallel[j];
+                }
+                avg_time_parallel += result.time_parallel[j];
+                if (min_time_dense == -1 || result.time_dense[j] < min_time_dense) {
+                    min_time_dense = result.time_dense[j];
+                }
+                if (result.time_dense[j] > max_time_dense) {
+                    max_time_dense = result.time_dense[j];
+                }
+                avg_time_dense += result.time_dense[j];
             }
             avg_time_generic = avg_time_generic / RUN_TIMES;
             avg_time_lift_to_front = avg_time_lift_to_front / RUN_TIMES;
             avg_time_difference = avg_time_difference / RUN_TIMES;
+            avg_time_parallel = avg_time_parallel / RUN_TIMES;
+            avg_time_dense = avg_time_dense / RUN_TIMES;
             // write the time results
             output_time_generic << i << ", " << result.edge_count << ", " << min_time_generic << ", " << max_time_generic << ", " << avg_time_generic;
             output_time_lift_to_front << i << ", " << result.edge_count << ", " << min_time_lift_to_front << ", " << max_time_lift_to_front << ", " << avg_time_lift_to_front;
             output_time_difference << i << ", " << result.edge_count << ", " << min_time_difference << ", " << max_time_difference << ", " << avg_time_difference;
+            output_time_parallel << i << ", " << result.edge_count << ", " << min_time_parallel << ", " << max_time_parallel << ", " << avg_time_parallel;
+            output_time_dense << i << ", " << result.edge_count << ", " << min_time_dense << ", " << max_time_dense << ", " << avg_time_dense;
             for (int j = 0; j < RUN_TIMES; j++) {
                 output_time_generic << ", " << result.time_generic[j];
                 output_time_lift_to_front << ", " << result.time_lift_to_front[j];
                 output_time_difference << ", " << result.time_generic[j] - result.time_lift_to_front[j];
+                output_time_parallel << ", " << result.time_parallel[j];
+                output_time_dense << ", " << result.time_dense[j];
             }
             output_time_generic << std::endl;
             output_time_lift_to_front << std::endl;
             output_time_difference << std::endl;
+            output_time_parallel << std::endl;
+            output_time_dense << std::endl;
             // write the memory results
-            output_memory_generic << i << ", " << result.edge_count << ", " << result.memory_generic << std::endl;
-            output_memory_lift_to_front << i << ", " << result.edge_count << ", " << result.memory_lift_to_front << std::endl;
-            output_memory_difference << i << ", " << result.edge_count << ", " << result.memory_lift_to_front - result.memory_generic << std::endl;
+            writeMemoryResult(output_memory_generic, i, result.edge_count, result.memory_generic);
+            writeMemoryResult(output_memory_lift_to_front, i, result.edge_count, result.memory_lift_to_front);
+            writeMemoryResult(output_memory_parallel, i, result.edge_count, result.memory_parallel);
+            writeMemoryResult(output_memory_dense, i, result.edge_count, result.memory_dense);
+            output_memory_difference << i << ", " << result.edge_count << ", " << result.memory_lift_to_front.build.peak_bytes - result.memory_generic.build.peak_bytes << ", " << result.memory_lift_to_front.solve.peak_bytes - result.memory_generic.solve.peak_bytes << std::endl;
             // print debug info
             if (v) {
-                std::cout << "[1] vertices: " << i << " avg_time[ms]: " << avg_time_generic << " memory[bytes]: " << result.memory_generic << std::endl;
-                std::cout << "[2] vertices: " << i << " avg_time[ms]: " << avg_time_lift_to_front << " memory[bytes]: " << result.memory_lift_to_front << std::endl;
+                std::cout << "[1] vertices: " << i << " avg_time[ms]: " << avg_time_generic << " peak_memory[bytes]: " << result.memory_generic.build.peak_bytes << " + " << result.memory_generic.solve.peak_bytes << std::endl;
+                std::cout << "[2] vertices: " << i << " avg_time[ms]: " << avg_time_lift_to_front << " peak_memory[bytes]: " << result.memory_lift_to_front.build.peak_bytes << " + " << result.memory_lift_to_front.solve.peak_bytes << std::endl;
+                std::cout << "[3] vertices: " << i << " avg_time[ms]: " << avg_time_parallel << " peak_memory[bytes]: " << result.memory_parallel.build.peak_bytes << " + " << result.memory_parallel.solve.peak_bytes << std::endl;
+                std::cout << "[4] vertices: " << i << " avg_time[ms]: " << avg_time_dense << " peak_memory[bytes]: " << result.memory_dense.build.peak_bytes << " + " << result.memory_dense.solve.peak_bytes << std::endl;
             }
         }
         // flush the output files
@@ -191,6 +343,10 @@ int main(int argc, char* argv[]) {
         output_memory_generic.flush();
         output_memory_lift_to_front.flush();
         output_memory_difference.flush();
+        output_time_parallel.flush();
+        output_memory_parallel.flush();
+        output_time_dense.flush();
+        output_memory_dense.flush();
         // close the output files
         output_time_generic.close();
         output_time_lift_to_front.close();
@@ -198,48 +354,276 @@ int main(int argc, char* argv[]) {
         output_memory_generic.close();
         output_memory_lift_to_front.close();
         output_memory_difference.close();
+        output_time_parallel.close();
+        output_memory_parallel.close();
+        output_time_dense.close();
+        output_memory_dense.close();
+    } else if (serve || socket_path != nullptr) {
+        // long running mode, every job names its graph and its terminals
+        if (m < MODE_GENERIC || m > MODE_AUTO || cache_size <= 0 || (order != "original" && order != "bfs" && order != "rcm")) {
+            std::cerr << "Invalid server parameters. Usage: solver --serve | --socket [socket path] [-m default solver mode] [-p threads] [--cache graphs kept in memory] [-g to enable global relabel] [--gap to enable gap heuristic] [--reduce to prune and contract the graph before solving] [--order original | bfs | rcm] [--capacity int32 | int64 | double]";
+            return 1;
+        }
+        VertexOrdering ordering = order == "bfs" ? BFS_ORDER : order == "rcm" ? RCM_ORDER : ORIGINAL_ORDER;
+        bool served;
+        if (capacity_type == "int64") {
+            served = runServer<int64_t>(socket_path, (SolverType) m, p, cache_size, g, gap, reduce, ordering);
+        } else if (capacity_type == "double") {
+            served = runServer<double>(socket_path, (SolverType) m, p, cache_size, g, gap, reduce, ordering);
+        } else if (capacity_type == "int32") {
+            served = runServer<int32_t>(socket_path, (SolverType) m, p, cache_size, g, gap, reduce, ordering);
+        } else {
+            std::cerr << "Invalid capacity type. Usage: solver --serve | --socket [socket path] [--capacity int32 | int64 | double]";
+            return 1;
+        }
+        if (!served) {
+            return 1;
+        }
+    } else if (convert != nullptr) {
+        // turn the text graph file into a binary one that can be mapped in memory
+        if (file == nullptr) {
+            std::cerr << "Missing -i input.txt argument. Usage: solver -i [source file] --convert [binary file] [--capacity int32 | int64 | double]";
+            return 1;
+        }
+        bool converted;
+        if (capacity_type == "int64") {
+            converted = GraphFile<int64_t>::convert(file, convert);
+        } else if (capacity_type == "double") {
+            converted = GraphFile<double>::convert(file, convert);
+        } else if (capacity_type == "int32") {
+            converted = GraphFile<int32_t>::convert(file, convert);
+        } else {
+            std::cerr << "Invalid capacity type. Usage: solver -i [source file] --convert [binary file] [--capacity int32 | int64 | double]";
+            return 1;
+        }
+        if (!converted) {
+            return 1;
+        }
     } else {
         // now validate those parameters
         if (file == nullptr) {
-            std::cerr << "Missing -i input.txt argument. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] -m [0: generic solver | 1: lift-to-front solver] [-v to enable verbose mode]";
+            std::cerr << "Missing -i input.txt argument. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] -m [0: generic solver | 1: lift-to-front solver | 2: highest-label solver | 3: parallel solver, always with global relabel | 4: FIFO solver | 5: dense solver | 6: Boykov-Kolmogorov solver | 7: Dinic solver | 8: excess scaling solver | auto: chosen from the graph, with global relabel and gap heuristic] [-p threads] [-g to enable global relabel] [--gap to enable gap heuristic] [--cut to print the minimum cut] [--stats to print the solver counters] [--reduce to prune and contract the graph before solving] [--order original | bfs | rcm] [--tree to print the Gomory-Hu tree of the undirected graph] [--capacity int32 | int64 | double] [-v to enable verbose mode] (the source file can be a text file, a DIMACS file or a binary one written by --convert)";
             return 1;
         }
-        if (s == -1 || t == -1) {
-            std::cerr << "Missing -s and -t arguments. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] -m [0: generic solver | 1: lift-to-front solver] [-v to enable verbose mode]";
+        if ((s == -1 || t == -1) && !tree && !DimacsReader<int32_t>::isDimacsFile(file)) {
+            std::cerr << "Missing -s and -t arguments. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] -m [0: generic solver | 1: lift-to-front solver | 2: highest-label solver | 3: parallel solver, always with global relabel | 4: FIFO solver | 5: dense solver | 6: Boykov-Kolmogorov solver | 7: Dinic solver | 8: excess scaling solver | auto: chosen from the graph, with global relabel and gap heuristic] [-p threads] [-g to enable global relabel] [--gap to enable gap heuristic] [--cut to print the minimum cut] [--stats to print the solver counters] [--reduce to prune and contract the graph before solving] [--order original | bfs | rcm] [--tree to print the Gomory-Hu tree of the undirected graph] [--capacity int32 | int64 | double] [-v to enable verbose mode]";
             return 1;
         }
-        if (m != MODE_GENERIC && m != MODE_LIFT_TO_FRONT) {
-            std::cerr << "Invalid solver mode. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] -m [0: generic solver | 1: lift-to-front solver] [-v to enable verbose mode]";
+        if (m != MODE_GENERIC && m != MODE_LIFT_TO_FRONT && m != MODE_HIGHEST_LABEL && m != MODE_PARALLEL && m != MODE_FIFO && m != MODE_DENSE && m != MODE_BOYKOV_KOLMOGOROV && m != MODE_DINIC && m != MODE_EXCESS_SCALING && m != MODE_AUTO) {
+            std::cerr << "Invalid solver mode. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] -m [0: generic solver | 1: lift-to-front solver | 2: highest-label solver | 3: parallel solver, always with global relabel | 4: FIFO solver | 5: dense solver | 6: Boykov-Kolmogorov solver | 7: Dinic solver | 8: excess scaling solver | auto: chosen from the graph, with global relabel and gap heuristic] [-p threads] [-g to enable global relabel] [--gap to enable gap heuristic] [--cut to print the minimum cut] [--stats to print the solver counters] [--reduce to prune and contract the graph before solving] [--order original | bfs | rcm] [--tree to print the Gomory-Hu tree of the undirected graph] [--capacity int32 | int64 | double] [-v to enable verbose mode]";
             return 1;
         }
-        // we can now open the file and read it
-        std::vector<FileLine> lines = readGraphFromFile(file);
-        int vertexCount = getGraphVertexCount(lines);
-        SolverType type = m == GENERIC_SOLVER ? SolverType::GENERIC_SOLVER : SolverType::LIFT_TO_FRONT_SOLVER;
-        // create an instance of the solver object
-        GoldbergProblemSolver solver(vertexCount, type, v);
-        // fill the graph using file data
-        for (auto &line : lines) {
-            solver.addEdge(line.u, line.v, line.capacity);
+        if (capacity_type != "int32" && capacity_type != "int64" && capacity_type != "double") {
+            std::cerr << "Invalid capacity type. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] [--capacity int32 | int64 | double]";
+            return 1;
+        }
+        if (order != "original" && order != "bfs" && order != "rcm") {
+            std::cerr << "Invalid vertex order. Usage: solver -i [source file] -s [source vertex] -t [destination vertex] [--order original | bfs | rcm]";
+            return 1;
+        }
+        VertexOrdering ordering = order == "bfs" ? BFS_ORDER : order == "rcm" ? RCM_ORDER : ORIGINAL_ORDER;
+        SolverType type;
+        switch (m) {
+            case MODE_LIFT_TO_FRONT:
+                type = SolverType::LIFT_TO_FRONT_SOLVER;
+                break;
+            case MODE_HIGHEST_LABEL:
+                type = SolverType::HIGHEST_LABEL_SOLVER;
+                break;
+            case MODE_PARALLEL:
+                type = SolverType::PARALLEL_SOLVER;
+                break;
+            case MODE_FIFO:
+                type = SolverType::FIFO_SOLVER;
+                break;
+            case MODE_DENSE:
+                type = SolverType::DENSE_SOLVER;
+                break;
+            case MODE_BOYKOV_KOLMOGOROV:
+                type = SolverType::BOYKOV_KOLMOGOROV_SOLVER;
+                break;
+            case MODE_DINIC:
+                type = SolverType::DINIC_SOLVER;
+                break;
+            case MODE_EXCESS_SCALING:
+                type = SolverType::EXCESS_SCALING_SOLVER;
+                break;
+            case MODE_AUTO:
+                type = SolverType::AUTO_SOLVER;
+                break;
+            default:
+                type = SolverType::GENERIC_SOLVER;
+                break;
+        }
+        // the solver is specialized at compile time for each capacity type
+        bool solved;
+        if (tree && capacity_type == "int64") {
+            solved = buildCutTree<int64_t>(file, s, t, type, p);
+        } else if (tree && capacity_type == "double") {
+            solved = buildCutTree<double>(file, s, t, type, p);
+        } else if (tree) {
+            solved = buildCutTree<int32_t>(file, s, t, type, p);
+        } else if (capacity_type == "int64") {
+            solved = solveGraphFromFile<int64_t>(file, s, t, type, v, stats, g, gap, p, cut, reduce, ordering);
+        } else if (capacity_type == "double") {
+            solved = solveGraphFromFile<double>(file, s, t, type, v, stats, g, gap, p, cut, reduce, ordering);
+        } else {
+            solved = solveGraphFromFile<int32_t>(file, s, t, type, v, stats, g, gap, p, cut, reduce, ordering);
+        }
+        if (!solved) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+template <typename Capacity>
+bool solveGraphFromFile(char* file, int s, int t, SolverType type, bool verbose, bool statistics, bool global_relabel, bool gap_heuristic, int threads, bool cut, bool reduce, VertexOrdering ordering) {
+    if (GraphFile<Capacity>::isGraphFile(file)) {
+        // binary files already contain the residual graph, they are mapped instead of parsed
+        GraphFile<Capacity> graphFile;
+        if (!graphFile.open(file) || !checkTerminals(s, t, graphFile.getVerticesCount())) {
+            return false;
+        }
+        GoldbergProblemSolver<Capacity> solver(graphFile.getVerticesCount(), type, verbose, statistics);
+        solver.loadGraphFile(graphFile);
+        graphFile.close();
+        solveGraph(solver, s, t, global_relabel, gap_heuristic, threads, cut, reduce, ordering, statistics);
+        return true;
+    }
+    if (DimacsReader<Capacity>::isDimacsFile(file)) {
+        // DIMACS files are parsed by all the threads, the terminals can be overridden by -s and -t
+        DimacsReader<Capacity> reader(threads);
+        if (!reader.read(file)) {
+            return false;
+        }
+        s = s == -1 ? reader.getSource() : s;
+        t = t == -1 ? reader.getSink() : t;
+        if (s == -1 || t == -1) {
+            std::cerr << "The DIMACS file " << file << " does not specify the source and the sink, use -s and -t" << std::endl;
+            return false;
+        }
+        if (!checkTerminals(s, t, reader.getVerticesCount())) {
+            return false;
+        }
+        GoldbergProblemSolver<Capacity> solver(reader.getVerticesCount(), type, verbose, statistics);
+        solver.loadDimacsFile(reader);
+        solveGraph(solver, s, t, global_relabel, gap_heuristic, threads, cut, reduce, ordering, statistics);
+        return true;
+    }
+    // we can now open the file and read it
+    std::vector<FileLine<Capacity>> lines = readGraphFromFile<Capacity>(file);
+    int vertexCount = getGraphVertexCount(lines);
+    if (!checkTerminals(s, t, vertexCount)) {
+        return false;
+    }
+    // create an instance of the solver object
+    GoldbergProblemSolver<Capacity> solver(vertexCount, type, verbose, statistics);
+    // fill the graph using file data, merging the parallel and the antiparallel edges
+    GraphBuilder<Capacity> builder(vertexCount);
+    builder.addEdges(lines.begin(), lines.end());
+    solver.loadGraphBuilder(builder);
+    solveGraph(solver, s, t, global_relabel, gap_heuristic, threads, cut, reduce, ordering, statistics);
+    return true;
+}
+
+template <typename Capacity>
+void solveGraph(GoldbergProblemSolver<Capacity> &solver, int s, int t, bool global_relabel, bool gap_heuristic, int threads, bool cut, bool reduce, VertexOrdering ordering, bool statistics) {
+    solver.setGlobalRelabel(global_relabel);
+    solver.setGapHeuristic(gap_heuristic);
+    solver.setReduction(reduce);
+    solver.setVertexOrdering(ordering);
+    if (threads > 0) {
+        solver.setThreadCount(threads);
+    }
+    if (cut) {
+        // calculate the minimum cut between two nodes
+        MinimumCut<Capacity> minimumCut = solver.getMinimumCut(s, t);
+        std::cout << "The maximum flow is: " << minimumCut.value << std::endl;
+        std::cout << "Source side: { ";
+        for (int vertex : minimumCut.source_side) {
+            std::cout << vertex << " ";
+        }
+        std::cout << "}" << std::endl;
+        for (auto &arc : minimumCut.arcs) {
+            std::cout << "Cut arc: " << arc.u << " -> " << arc.v << " capacity: " << arc.capacity << std::endl;
         }
+    } else {
         // calculate the maximum flow between two nodes
-        int flow = solver.getMaximumFlow(s, t);
+        Capacity flow = solver.getMaximumFlow(s, t);
         std::cout << "The maximum flow is: " << flow << std::endl;
     }
-    return 0;
+    if (statistics) {
+        solver.getStatistics().print(std::cout);
+    }
+}
+
+/**
+ * Compute the minimum cuts between all the pairs of vertices of a text graph file, whose edges
+ * are read as undirected, and print the tree that contains them.
+ * @param s if not -1, the minimum cut between s and t is printed too.
+ * @param threads number of cuts computed at the same time, all the cores if not positive.
+ * @return false if the file is not a text graph file.
+ */
+template <typename Capacity>
+bool buildCutTree(char* file, int s, int t, SolverType type, int threads) {
+    if (GraphFile<Capacity>::isGraphFile(file) || DimacsReader<Capacity>::isDimacsFile(file)) {
+        std::cerr << "The tree can only be built from a text graph file" << std::endl;
+        return false;
+    }
+    std::vector<FileLine<Capacity>> lines = readGraphFromFile<Capacity>(file);
+    int vertexCount = getGraphVertexCount(lines);
+    GomoryHuTree<Capacity> tree(vertexCount, type);
+    for (auto &line : lines) {
+        tree.addEdge(line.u, line.v, line.capacity);
+    }
+    tree.build(threads > 0 ? threads : (int) std::thread::hardware_concurrency());
+    for (int v = 1; v < vertexCount; v++) {
+        std::cout << "Tree edge: " << v << " - " << tree.getParent(v) << " minimum cut: " << tree.getParentCut(v) << std::endl;
+    }
+    if (s != -1 && t != -1 && s != t) {
+        std::cout << "The minimum cut between " << s << " and " << t << " is: " << tree.getMinimumCut(s, t) << std::endl;
+    }
+    return true;
 }
 
-std::vector<FileLine> readGraphFromFile(char* file) {
+/**
+ * Solve the jobs read from the standard input, or from the clients of a Unix socket, until the
+ * end of the input or a "quit" line. The settings apply to every job.
+ * @param socket_path the socket of the server, null to read the standard input.
+ * @param type the solver mode of the jobs that do not specify one.
+ * @param threads number of jobs solved at the same time, all the cores if not positive.
+ * @param cache_size number of graph files kept in memory.
+ * @return false if the socket cannot be created.
+ */
+template <typename Capacity>
+bool runServer(char* socket_path, SolverType type, int threads, int cache_size, bool global_relabel, bool gap_heuristic, bool reduce, VertexOrdering ordering) {
+    JobServer<Capacity> server(threads, (size_t) cache_size, type);
+    server.setGlobalRelabel(global_relabel);
+    server.setGapHeuristic(gap_heuristic);
+    server.setReduction(reduce);
+    server.setVertexOrdering(ordering);
+    if (socket_path != nullptr) {
+        return server.serveSocket(socket_path);
+    }
+    server.serve(std::cin, std::cout);
+    return true;
+}
+
+template <typename Capacity>
+std::vector<FileLine<Capacity>> readGraphFromFile(char* file) {
     std::ifstream infile(file);
-    std::vector<FileLine> lines;
-    int u, v, capacity;
+    std::vector<FileLine<Capacity>> lines;
+    int u, v;
+    Capacity capacity;
     while (infile >> u >> v >> capacity) {
         lines.emplace_back(u, v, capacity);
     }
     return lines;
 }
 
-int getGraphVertexCount(std::vector<FileLine> lines) {
+template <typename Capacity>
+int getGraphVertexCount(const std::vector<FileLine<Capacity>> &lines) {
     int maximum = -1;
     for (auto &line : lines) {
         if (line.u > maximum) {
@@ -252,67 +636,101 @@ int getGraphVertexCount(std::vector<FileLine> lines) {
     return maximum + 1;
 }
 
-BenchmarkResult execute_benchmark(int vertices) {
+/**
+ * The source and the sink must be two different vertices of the graph, like for the jobs of the
+ * server: otherwise each solver would answer in its own way.
+ * @param s the source vertex.
+ * @param t the sink vertex.
+ * @param vertices_count number of vertices of the graph.
+ * @return true if the terminals are valid, false after printing the error otherwise.
+ */
+bool checkTerminals(int s, int t, int vertices_count) {
+    if (s < 0 || t < 0 || s >= vertices_count || t >= vertices_count || s == t) {
+        std::cerr << "Invalid source or sink: they must be two different vertices between 0 and " << vertices_count - 1 << std::endl;
+        return false;
+    }
+    return true;
+}
+
+BenchmarkResult execute_benchmark(int vertices, bool global_relabel, bool gap_heuristic, int threads) {
     // initialize the random library
     std::mt19937 rng;
     rng.seed(std::random_device()());
     std::uniform_int_distribution<std::mt19937::result_type> generator(0, 50);
-    // keep track of the number of edges
-    int edge_count = 0;
-    // create the adjacent matrix and initialize both graph with the same data
-    GenericGraph genericGraph(vertices);
-    LiftToFrontGraph liftToFrontGraph(vertices);
+    // generate the edges once, all the graphs receive the same data
+    std::vector<Edge<int32_t>> edges;
     for(int u = 0; u < vertices; u++) {
         for (int v = u; v < vertices; v++) {
             if(v != u) {
                 auto weight = static_cast<int>(generator(rng));
                 if (weight > 0) {
-                    edge_count += 1;
-                    genericGraph.addEdge(u, v, weight);
-                    liftToFrontGraph.addEdge(u, v, weight);
+                    edges.emplace_back(u, v, weight);
                 }
             }
         }
     }
-    // keep track of more than one run
-    long time_generic[RUN_TIMES];
-    long time_lift_to_front[RUN_TIMES];
+    BenchmarkResult result {};
+    result.edge_count = (int) edges.size();
+    // each graph is built and solved on its own, so that its memory can be measured
+    benchmarkGraph<GenericGraph<int32_t>>(vertices, edges, global_relabel, gap_heuristic, threads, result.time_generic, result.memory_generic);
+    benchmarkGraph<LiftToFrontGraph<int32_t>>(vertices, edges, global_relabel, gap_heuristic, threads, result.time_lift_to_front, result.memory_lift_to_front);
+    benchmarkGraph<ParallelGraph<int32_t>>(vertices, edges, global_relabel, gap_heuristic, threads, result.time_parallel, result.memory_parallel);
+    benchmarkGraph<DenseGraph<int32_t>>(vertices, edges, global_relabel, gap_heuristic, threads, result.time_dense, result.memory_dense);
+    return result;
+}
+
+/**
+ * Build a graph and solve it RUN_TIMES times, measuring the memory of the build and of the first run.
+ * @param vertices number of vertices of the graph.
+ * @param edges edges of the graph.
+ * @param time filled with the time of each run, in milliseconds.
+ * @param memory filled with the memory used by the two phases.
+ */
+template <typename Graph>
+void benchmarkGraph(int vertices, const std::vector<Edge<int32_t>> &edges, bool global_relabel, bool gap_heuristic, int threads, long time[RUN_TIMES], MemoryResult &memory) {
+    MemoryTracker tracker;
+    tracker.begin();
+    Graph graph(vertices);
+    graph.setGlobalRelabel(global_relabel);
+    graph.setGapHeuristic(gap_heuristic);
+    if (threads > 0) {
+        graph.setThreadCount(threads);
+    }
+    for (auto &edge : edges) {
+        graph.addEdge(edge.u, edge.v, edge.capacity);
+    }
+    memory.build = tracker.end();
     // retry the same algorithm 10 times
     for (int i = 0; i < RUN_TIMES; i++) {
-        // ########################################################################
-        // #                         GENERIC ALGORITHM                            #
-        // ########################################################################
-        // before starting, take note of the time
-        long start_generic = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-        // it's time to start the algorithm
-        genericGraph.getMaximumFlow(0, vertices - 1);
-        // algorithm has finished, take note of the time
-        long end_generic = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-        // we can now see how much time has been consumed
-        time_generic[i] = end_generic - start_generic;
-        // ########################################################################
-        // #                      LIFT TO FRONT ALGORITHM                         #
-        // ########################################################################
+        if (i == 0) {
+            tracker.begin();
+        }
         // before starting, take note of the time
-        auto start_lift_to_front = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        long start = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
         // it's time to start the algorithm
-        liftToFrontGraph.getMaximumFlow(0, vertices - 1);
+        graph.getMaximumFlow(0, vertices - 1);
         // algorithm has finished, take note of the time
-        auto end_lift_to_front = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        long end = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (i == 0) {
+            memory.solve = tracker.end();
+        }
         // we can now see how much time has been consumed
-        time_lift_to_front[i] = end_lift_to_front - start_lift_to_front;
+        time[i] = end - start;
+    }
+}
+
+void writeMemoryHeader(std::ofstream &output) {
+    output << "vertex_count, edge_count";
+    for (const char* phase : {"build", "solve"}) {
+        output << ", " << phase << "_allocated [bytes], " << phase << "_allocations, " << phase << "_peak [bytes], " << phase << "_retained [bytes], " << phase << "_peak_rss [bytes]";
+    }
+    output << std::endl;
+}
+
+void writeMemoryResult(std::ofstream &output, int vertices, int edge_count, const MemoryResult &memory) {
+    output << vertices << ", " << edge_count;
+    for (const MemoryUsage* usage : {&memory.build, &memory.solve}) {
+        output << ", " << usage->allocated_bytes << ", " << usage->allocations << ", " << usage->peak_bytes << ", " << usage->retained_bytes << ", " << usage->peak_rss;
     }
-    // calculate the size of memory used by the generic algorithm
-    long memory_generic =
-                    (vertices * sizeof(Vertex)) +
-                    sizeof(Edge*) + (vertices * vertices * sizeof(Edge*)) +
-                    (2 * edge_count * sizeof(Edge));
-    // calculate the size of memory used by the lift-to-front algorithm
-    long memory_lift_to_front =
-                    (vertices * sizeof(Vertex)) +
-                    sizeof(Edge*) + (vertices * vertices * sizeof(Edge*)) +
-                    (2 * edge_count * sizeof(Edge) +
-                     (vertices * sizeof(int)));
-    // return the result to the caller, the memory used is released
-    return BenchmarkResult(edge_count, time_generic, memory_generic, time_lift_to_front, memory_lift_to_front);
+    output << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+#include "memory_tracker.h"
+
+static std::atomic<long long> live_bytes(0);
+static std::atomic<long long> peak_bytes(0);
+static std::atomic<long long> allocated_bytes(0);
+static std::atomic<long long> allocations(0);
+
+// the global operator new is only replaced in the test build, the other builds see zero heap counters
+#ifdef MEMORY_TRACKER
+
+// each block starts with its size, the header keeps the alignment given by malloc
+#define ALLOCATION_HEADER 16
+
+static void* trackedAllocate(size_t size) {
+    void* block = malloc(size + ALLOCATION_HEADER);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    *static_cast<size_t*>(block) = size;
+    long long live = live_bytes.fetch_add((long long) size, std::memory_order_relaxed) + (long long) size;
+    long long peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        // peak has been reloaded by the failed exchange
+    }
+    allocated_bytes.fetch_add((long long) size, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<char*>(block) + ALLOCATION_HEADER;
+}
+
+static void trackedRelease(void* pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+    void* block = static_cast<char*>(pointer) - ALLOCATION_HEADER;
+    live_bytes.fetch_sub((long long) *static_cast<size_t*>(block), std::memory_order_relaxed);
+    free(block);
+}
+
+static void* trackedNew(size_t size) {
+    while (true) {
+        void* pointer = trackedAllocate(size);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        // give the new handler a chance to release some memory, as the standard operator does
+        std::new_handler handler = std::set_new_handler(nullptr);
+        std::set_new_handler(handler);
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new(size_t size) {
+    return trackedNew(size);
+}
+
+void* operator new[](size_t size) {
+    return trackedNew(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t &) noexcept {
+    return trackedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return trackedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    trackedRelease(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    trackedRelease(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    trackedRelease(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    trackedRelease(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t &) noexcept {
+    trackedRelease(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t &) noexcept {
+    trackedRelease(pointer);
+}
+
+#endif
+
+MemoryTracker::MemoryTracker() {
+    this->start_live_bytes = 0;
+    this->start_allocated_bytes = 0;
+    this->start_allocations = 0;
+}
+
+/**
+ * Start a new phase: the peak of the heap and, where the system allows it, the peak resident
+ * set size are reset to the current values.
+ */
+void MemoryTracker::begin() {
+    // on Linux writing 5 in clear_refs resets the peak resident set size of the process
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs) {
+        clear_refs << "5";
+    }
+    clear_refs.close();
+    this->start_live_bytes = live_bytes.load();
+    this->start_allocated_bytes = allocated_bytes.load();
+    this->start_allocations = allocations.load();
+    peak_bytes.store(this->start_live_bytes);
+}
+
+/**
+ * @return the memory used since the last call to begin().
+ */
+MemoryUsage MemoryTracker::end() const {
+    MemoryUsage usage {};
+    usage.allocated_bytes = allocated_bytes.load() - this->start_allocated_bytes;
+    usage.allocations = allocations.load() - this->start_allocations;
+    usage.peak_bytes = peak_bytes.load() - this->start_live_bytes;
+    usage.retained_bytes = live_bytes.load() - this->start_live_bytes;
+    usage.peak_rss = getPeakRss();
+    return usage;
+}
+
+long long MemoryTracker::getLiveBytes() {
+    return live_bytes.load();
+}
+
+/**
+ * Read the peak resident set size from /proc/self/status, falling back to getrusage on the
+ * systems without it (where the peak cannot be reset and covers the whole process lifetime).
+ * @return the peak resident set size in bytes.
+ */
+long long MemoryTracker::getPeakRss() {
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        if (key == "VmHWM:") {
+            long long kilobytes;
+            if (status >> kilobytes) {
+                return kilobytes * 1024;
+            }
+            break;
+        }
+        status.ignore(256, '\n');
+    }
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return (long long) usage.ru_maxrss * 1024;
+}
\ No newline at end of file
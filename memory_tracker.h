@@ -0,0 +1,54 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_MEMORY_TRACKER_H
+#define ADVANCEDALGORITHMSPROJECT_MEMORY_TRACKER_H
+
+/**
+ * Memory used by the program during a phase. The heap figures are measured by the global
+ * operator new and delete, so they include the growth of the containers and the allocations
+ * made by the standard library, but not the allocator overhead of each block.
+ */
+struct MemoryUsage {
+
+    // bytes requested and number of allocations made during the phase
+    long long allocated_bytes;
+    long long allocations;
+
+    // highest amount of heap memory in use during the phase, above the one in use at its beginning
+    long long peak_bytes;
+
+    // heap memory still in use at the end of the phase, above the one in use at its beginning
+    long long retained_bytes;
+
+    // highest resident set size of the process during the phase
+    long long peak_rss;
+
+};
+
+/**
+ * Measures the memory used between a call to begin() and a call to end(). The counters are
+ * shared by the whole process, so only one phase should be measured at a time. The heap is
+ * only counted when MEMORY_TRACKER is defined, as in the AdvancedAlgorithmsTest target.
+ */
+class MemoryTracker {
+
+    long long start_live_bytes;
+    long long start_allocated_bytes;
+    long long start_allocations;
+
+public:
+
+    MemoryTracker();
+
+    void begin();
+
+    MemoryUsage end() const;
+
+    static long long getLiveBytes();
+
+    static long long getPeakRss();
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_MEMORY_TRACKER_H
\ No newline at end of file
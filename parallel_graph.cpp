@@ -0,0 +1,293 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <iostream>
+#include <algorithm>
+#include "parallel_graph.h"
+#include "push_relabel_graph_impl.h"
+
+/**
+ * Add some excess to an atomic counter: floating point atomics have no fetch_add,
+ * so a compare-and-swap loop is used, while integers use the native instruction.
+ */
+template <typename Capacity>
+static void atomicAdd(std::atomic<Capacity> &target, Capacity value) {
+    Capacity current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+        // current has been reloaded by the failed exchange
+    }
+}
+
+static void atomicAdd(std::atomic<int32_t> &target, int32_t value) {
+    target.fetch_add(value, std::memory_order_relaxed);
+}
+
+static void atomicAdd(std::atomic<int64_t> &target, int64_t value) {
+    target.fetch_add(value, std::memory_order_relaxed);
+}
+
+template <typename Capacity, typename Statistics>
+ParallelGraph<Capacity, Statistics>::ParallelGraph(int vertices_count) : Base(vertices_count) {
+    this->added_excess.reset(new std::atomic<Capacity>[vertices_count]);
+    this->discovered.reset(new std::atomic<bool>[vertices_count]);
+    for (int i = 0; i < vertices_count; i++) {
+        this->added_excess[i].store(0);
+        this->discovered[i].store(false);
+    }
+    this->new_label.assign(vertices_count, DEFAULT_LABEL);
+    this->cursor.store(0);
+}
+
+/**
+ * Create the pool the first time the graph is solved or when the number of threads changed.
+ */
+template <typename Capacity, typename Statistics>
+void ParallelGraph<Capacity, Statistics>::prepareThreads() {
+    if (!this->pool || this->pool->size() != this->threads_count) {
+        this->pool.reset(new ThreadPool(this->threads_count));
+    }
+    this->thread_active.assign(this->threads_count, std::vector<int>());
+    this->thread_work.assign(this->threads_count, 0);
+    this->thread_statistics.assign(this->threads_count, Statistics());
+}
+
+/**
+ * Level-synchronous backward breadth-first search from the sink: the vertices of each level are
+ * split between the threads and a vertex is claimed by the first thread that reaches it. The
+ * vertices that cannot reach the sink get label V and will not be discharged anymore.
+ */
+template <typename Capacity, typename Statistics>
+void ParallelGraph<Capacity, Statistics>::parallelGlobalRelabel() {
+    typename Statistics::Timer start = this->statistics.startTimer();
+    auto vertices_count = (int) this->vertices.size();
+    for (int i = 0; i < vertices_count; i++) {
+        this->vertices[i].label = vertices_count;
+        this->discovered[i].store(false, std::memory_order_relaxed);
+    }
+    this->vertices[this->sink].label = 0;
+    this->discovered[this->sink].store(true, std::memory_order_relaxed);
+    this->discovered[this->source].store(true, std::memory_order_relaxed);
+    std::vector<int> frontier(1, this->sink);
+    while (!frontier.empty()) {
+        this->cursor.store(0);
+        this->pool->run([this, &frontier](int thread_id) {
+            std::vector<int> &next = this->thread_active[thread_id];
+            next.clear();
+            auto size = (int) frontier.size();
+            int begin;
+            while ((begin = this->cursor.fetch_add(PARALLEL_CHUNK_SIZE)) < size) {
+                int end = std::min(begin + PARALLEL_CHUNK_SIZE, size);
+                for (int k = begin; k < end; k++) {
+                    int w = frontier[k];
+                    for (int arc = this->first_arc[w]; arc < this->first_arc[w + 1]; arc++) {
+                        int i = this->arc_head[arc];
+                        // vertex i can reach w if the reverse arc i->w has some residual capacity
+                        if (this->isPositive(this->arc_residual[this->arc_reverse[arc]]) &&
+                            !this->discovered[i].load(std::memory_order_relaxed) &&
+                            !this->discovered[i].exchange(true)) {
+                            this->vertices[i].label = this->vertices[w].label + 1;
+                            next.push_back(i);
+                        }
+                    }
+                }
+            }
+        });
+        frontier.clear();
+        for (auto &next : this->thread_active) {
+            frontier.insert(frontier.end(), next.begin(), next.end());
+        }
+    }
+    for (int i = 0; i < vertices_count; i++) {
+        this->discovered[i].store(false, std::memory_order_relaxed);
+    }
+    this->relabel_work = 0;
+    this->countLabels();
+    this->statistics.countGlobalRelabel();
+    this->statistics.addGlobalRelabelTime(start);
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Global relabel done" << std::endl;
+    }
+}
+
+/**
+ * Discharge vertex v using the labels and the excesses of the beginning of the round. When
+ * two adjacent vertices are both active only one of them (the winner) may use the arcs between
+ * them, so no residual capacity is ever updated by two threads at the same time.
+ * @param v index of the active vertex.
+ * @param next list receiving the vertices that will be active in the next round.
+ * @param statistics counters of the thread running the discharge.
+ * @return the number of arcs scanned.
+ */
+template <typename Capacity, typename Statistics>
+long ParallelGraph<Capacity, Statistics>::dischargeSnapshot(int v, std::vector<int> &next, Statistics &statistics) {
+    auto vertices_count = (int) this->vertices.size();
+    int label = this->vertices[v].label;
+    Capacity excess = this->vertices[v].excess;
+    long work = 0;
+    while (this->isPositive(excess)) {
+        int minimum = vertices_count;
+        bool skipped = false;
+        for (int arc = this->first_arc[v]; arc < this->first_arc[v + 1] && this->isPositive(excess); arc++) {
+            work += 1;
+            int w = this->arc_head[arc];
+            int w_label = this->vertices[w].label;
+            bool w_active = w != this->sink && w != this->source && this->isPositive(this->vertices[w].excess) && w_label < vertices_count;
+            if (w_active) {
+                // the winner is decided with the labels of the snapshot
+                int v_label = this->vertices[v].label;
+                bool win = v_label == w_label + 1 || v_label < w_label - 1 || (v_label == w_label && v < w);
+                if (!win) {
+                    skipped = true;
+                    continue;
+                }
+            }
+            Capacity residual = this->arc_residual[arc];
+            if (this->isPositive(residual) && label == w_label + 1) {
+                Capacity flow = std::min(residual, excess);
+                this->arc_residual[arc] -= flow;
+                this->arc_residual[this->arc_reverse[arc]] += flow;
+                excess -= flow;
+                residual -= flow;
+                statistics.countPush(!this->isPositive(residual));
+                atomicAdd(this->added_excess[w], flow);
+                if (w != this->sink && !this->discovered[w].load(std::memory_order_relaxed) && !this->discovered[w].exchange(true)) {
+                    next.push_back(w);
+                }
+            }
+            if (this->isPositive(residual) && w_label >= label) {
+                minimum = std::min(minimum, w_label + 1);
+            }
+        }
+        if (!this->isPositive(excess) || skipped) {
+            break;
+        }
+        // local relabel, the other threads keep seeing the old label until the end of the round
+        label = minimum;
+        statistics.countRelabel();
+        if (label >= vertices_count) {
+            break;
+        }
+    }
+    this->new_label[v] = label;
+    statistics.countDischarge();
+    statistics.countArcScans(work);
+    atomicAdd(this->added_excess[v], excess - this->vertices[v].excess);
+    if (this->isPositive(excess) && label < vertices_count && !this->discovered[v].exchange(true)) {
+        next.push_back(v);
+    }
+    return work;
+}
+
+/**
+ * Publish the result of a round: new labels of the discharged vertices, excess received by every
+ * touched vertex, and the list of the active vertices for the next round. With the gap heuristic
+ * the lowest label left empty by the round lifts all the vertices above it.
+ */
+template <typename Capacity, typename Statistics>
+void ParallelGraph<Capacity, Statistics>::applyRound() {
+    auto vertices_count = (int) this->vertices.size();
+    int empty_label = vertices_count;
+    for (int v : this->active) {
+        int previous = this->vertices[v].label;
+        this->vertices[v].label = this->new_label[v];
+        this->vertices[v].excess += this->added_excess[v].exchange(0, std::memory_order_relaxed);
+        if (this->gap_heuristic && previous != this->new_label[v]) {
+            this->label_count[previous] -= 1;
+            this->label_count[this->new_label[v]] += 1;
+            if (this->label_count[previous] == 0 && previous < empty_label) {
+                empty_label = previous;
+            }
+        }
+    }
+    // the vertices lifted by the gap are left out of the next round
+    if (empty_label < vertices_count) {
+        this->gap(empty_label);
+    }
+    this->vertices[this->sink].excess += this->added_excess[this->sink].exchange(0, std::memory_order_relaxed);
+    this->active.clear();
+    for (auto &next : this->thread_active) {
+        for (int v : next) {
+            this->vertices[v].excess += this->added_excess[v].exchange(0, std::memory_order_relaxed);
+            this->discovered[v].store(false, std::memory_order_relaxed);
+            if (this->isPositive(this->vertices[v].excess) && this->vertices[v].label < vertices_count) {
+                this->active.push_back(v);
+            }
+        }
+    }
+}
+
+template <typename Capacity, typename Statistics>
+Capacity ParallelGraph<Capacity, Statistics>::getMaximumFlow(int s, int t) {
+    auto vertices_count = (int) this->vertices.size();
+    this->statistics.reset();
+    typename Statistics::Timer start = this->statistics.startTimer();
+    // the algorithm start pre-processing input data
+    this->preProcess(s, t);
+    prepareThreads();
+    // the labels are always initialized with the exact distances from the sink, the -g flag is not
+    // needed: without the global relabel the rule that picks the winner between two active
+    // neighbours can leave every vertex of a cycle waiting for another one, and no round progresses
+    parallelGlobalRelabel();
+    for (int i = 0; i < vertices_count; i++) {
+        if (i != s && i != t && this->isPositive(this->vertices[i].excess) && this->vertices[i].label < vertices_count) {
+            this->active.push_back(i);
+        }
+    }
+    this->statistics.addInitializationTime(start);
+    start = this->statistics.startTimer();
+    if (Statistics::enabled) {
+        this->printCurrentStatus();
+    }
+    int rounds = 0;
+    while (!this->active.empty()) {
+        if (Statistics::enabled && this->verbose) {
+            std::cout << "=> Round " << rounds << " with " << this->active.size() << " active nodes" << std::endl;
+        }
+        // discharge all the active vertices concurrently
+        this->cursor.store(0);
+        this->pool->run([this](int thread_id) {
+            std::vector<int> &next = this->thread_active[thread_id];
+            next.clear();
+            long work = 0;
+            auto size = (int) this->active.size();
+            int begin;
+            while ((begin = this->cursor.fetch_add(PARALLEL_CHUNK_SIZE)) < size) {
+                int end = std::min(begin + PARALLEL_CHUNK_SIZE, size);
+                for (int k = begin; k < end; k++) {
+                    work += dischargeSnapshot(this->active[k], next, this->thread_statistics[thread_id]);
+                }
+            }
+            this->thread_work[thread_id] = work;
+        });
+        applyRound();
+        if (Statistics::enabled) {
+            for (auto &statistics : this->thread_statistics) {
+                this->statistics.merge(statistics);
+                statistics.reset();
+            }
+        }
+        // recompute the labels once enough work has been done
+        for (long work : this->thread_work) {
+            this->relabel_work += work;
+        }
+        if (this->global_relabel_frequency * this->relabel_work > GLOBAL_RELABEL_ALPHA * vertices_count + this->arc_head.size() / 2) {
+            parallelGlobalRelabel();
+            auto last = std::remove_if(this->active.begin(), this->active.end(), [this, vertices_count](int v) {
+                return this->vertices[v].label >= vertices_count;
+            });
+            this->active.erase(last, this->active.end());
+        }
+        rounds += 1;
+    }
+    this->statistics.addDischargeTime(start);
+    if (Statistics::enabled) {
+        this->printCurrentStatus();
+    }
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Rounds count: " << rounds << std::endl;
+    }
+    // no more active node found, return the maximum flow
+    return this->vertices[t].excess;
+}
+
+INSTANTIATE_PUSH_RELABEL_GRAPH(ParallelGraph)
\ No newline at end of file
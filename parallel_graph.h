@@ -0,0 +1,68 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_PARALLEL_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_PARALLEL_GRAPH_H
+
+#include <atomic>
+#include <memory>
+#include "push_relabel_graph.h"
+#include "thread_pool.h"
+
+// number of vertices taken at once by a thread from the shared work queue
+#define PARALLEL_CHUNK_SIZE 16
+
+/**
+ * Synchronous parallel push-relabel: in each round all the active vertices are discharged
+ * concurrently against a snapshot of the labels and the excesses, then the new labels and the
+ * received excess are applied together. Only the first phase is computed, so at the end the
+ * excess of the sink is the value of the maximum flow but the preflow is not turned into a flow.
+ * The global relabel runs in parallel between two rounds and it is always used, whatever the
+ * setting of the graph, since the rounds only progress on labels recomputed from time to time.
+ * The gap heuristic is checked when a round is applied, only when it is enabled.
+ */
+template <typename Capacity, typename Statistics = NoStatistics>
+class ParallelGraph final : public PushRelabelGraph<Capacity, Statistics, ParallelGraph<Capacity, Statistics>> {
+
+    typedef PushRelabelGraph<Capacity, Statistics, ParallelGraph<Capacity, Statistics>> Base;
+
+    // the main loop calls the hooks of the selection rule directly
+    friend Base;
+
+    std::unique_ptr<ThreadPool> pool;
+
+    // excess received by each vertex during the current round
+    std::unique_ptr<std::atomic<Capacity>[]> added_excess;
+
+    // set once a vertex has been scheduled for the next round
+    std::unique_ptr<std::atomic<bool>[]> discovered;
+
+    // label computed by the discharge of each active vertex in the current round
+    std::vector<int> new_label;
+
+    // active vertices of the current round and the ones found by each thread for the next one
+    std::vector<int> active;
+    std::vector<std::vector<int>> thread_active;
+    std::vector<long> thread_work;
+    std::vector<Statistics> thread_statistics;
+
+    // shared position in the work queue
+    std::atomic<int> cursor;
+
+    void prepareThreads();
+
+    void parallelGlobalRelabel();
+
+    long dischargeSnapshot(int v, std::vector<int> &next, Statistics &statistics);
+
+    void applyRound();
+
+public:
+
+    explicit ParallelGraph(int vertices_count);
+
+    Capacity getMaximumFlow(int s, int t) override;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_PARALLEL_GRAPH_H
\ No newline at end of file
@@ -0,0 +1,90 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_PUSH_RELABEL_GRAPH_H
+#define ADVANCEDALGORITHMSPROJECT_PUSH_RELABEL_GRAPH_H
+
+#include "base_graph.h"
+#include "solver_statistics.h"
+
+/**
+ * Push-relabel algorithm on top of the residual graph: the variations of the graph only decide
+ * which active vertex is discharged next. The statistics policy is a template parameter, so the
+ * counters and the verbose output only exist in the graphs compiled with CountingStatistics.
+ *
+ * The selection rule is a compile-time policy too: each variation passes itself as Derived and
+ * hides the hooks it needs (activate, onLabelsUpdated, preProcess, getActiveNode, discharge and
+ * relabel). The main loop calls them through derived(), so there is no virtual call per step and
+ * the hooks can be inlined in it. The only virtual calls left are the public entry points.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+class PushRelabelGraph : public BaseGraph<Capacity> {
+
+    Derived& derived() {
+        return *static_cast<Derived*>(this);
+    }
+
+protected:
+
+    // number of vertices (the source excluded) with each label, used by the gap heuristic
+    std::vector<int> label_count;
+
+    // work done by relabel operations since the last global relabel
+    long relabel_work;
+
+    // stop as soon as no active vertex can reach the sink anymore
+    bool phase_one_only;
+
+    Statistics statistics;
+
+    Capacity execute();
+
+    void addExcess(int v, Capacity amount);
+
+    void setArcCapacity(int arc, Capacity capacity) override;
+
+    void repairArc(int arc) override;
+
+    void lowerLabel(int v, int label);
+
+    void cancelDeficit(int v);
+
+    void globalRelabel();
+
+    void countLabels();
+
+    void gap(int label);
+
+    bool isActive(int v);
+
+    void activate(int v);
+
+    void onLabelsUpdated();
+
+    void preProcess(int s, int t);
+
+    int getActiveNode(int s, int t);
+
+    void push(int u, int arc);
+
+    void discharge(int u);
+
+    bool relabel(int u);
+
+public:
+
+    explicit PushRelabelGraph(int vertices_count);
+
+    Capacity getMaximumFlow(int s, int t) override;
+
+    MinimumCut<Capacity> getMinimumCut(int s, int t) override;
+
+    Capacity resolveMaximumFlow() override;
+
+    MinimumCut<Capacity> resolveMinimumCut() override;
+
+    SolverStatistics getStatistics() override;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_PUSH_RELABEL_GRAPH_H
\ No newline at end of file
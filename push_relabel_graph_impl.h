@@ -0,0 +1,547 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_PUSH_RELABEL_GRAPH_IMPL_H
+#define ADVANCEDALGORITHMSPROJECT_PUSH_RELABEL_GRAPH_IMPL_H
+
+#include <iostream>
+#include <algorithm>
+#include "push_relabel_graph.h"
+
+// The definitions of PushRelabelGraph are included by the source file of each variation, which
+// instantiates them together with its own hooks so that the compiler can inline them.
+
+template <typename Capacity, typename Statistics, typename Derived>
+PushRelabelGraph<Capacity, Statistics, Derived>::PushRelabelGraph(int vertices_count) : BaseGraph<Capacity>(vertices_count) {
+    this->relabel_work = 0;
+    this->phase_one_only = false;
+}
+
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::preProcess(int s, int t) {
+    // the previous run is discarded
+    this->solved = false;
+    // make sure the residual graph reflects the edge list
+    if (!this->arcs_built) {
+        this->buildArcs();
+    }
+    this->source = s;
+    this->sink = t;
+    // the label of the source vertex is set to the number of vertices
+    // the label of all the other vertices (different from s) is set to 0
+    for (int i = 0; i < this->vertices.size(); i++) {
+        this->vertices[i].label = (i != s) ? 0 : (int) this->vertices.size();
+        this->vertices[i].excess = DEFAULT_EXCESS;
+    }
+    // every arc starts with no flow on it
+    this->arc_residual = this->arc_capacity;
+    this->current_arc.assign(this->first_arc.begin(), this->first_arc.end() - 1);
+    // for each arc that goes from source to another vertex, the flow is set equal
+    // to the capacity and the excess of the destination vertex is increased by the capacity
+    for (int arc = this->first_arc[s]; arc < this->first_arc[s + 1]; arc++) {
+        Capacity flow = this->arc_residual[arc];
+        int i = this->arc_head[arc];
+        if (this->isPositive(flow)) {
+            this->arc_residual[arc] = 0;
+            if (!this->isPositive(this->vertices[i].excess) && i != s && i != t) {
+                this->derived().activate(i);
+            }
+            this->vertices[i].excess += flow;
+            // the reverse arc must be able to return the flow
+            this->arc_residual[this->arc_reverse[arc]] += flow;
+        }
+    }
+    countLabels();
+}
+
+/**
+ * Count how many vertices have each label. The labels never exceed 2 * V,
+ * which is the one given by the global relabel to unreachable vertices.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::countLabels() {
+    if (this->gap_heuristic) {
+        this->label_count.assign(2 * this->vertices.size() + 1, 0);
+        for (int i = 0; i < this->vertices.size(); i++) {
+            if (i != this->source) {
+                this->label_count[this->vertices[i].label] += 1;
+            }
+        }
+    }
+}
+
+/**
+ * No vertex has the given label anymore: all the vertices with a higher label (below V)
+ * cannot reach the sink, so they are lifted to V + 1 at once instead of one relabel at a time.
+ * @param label the label that has been emptied.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::gap(int label) {
+    auto vertices_count = (int) this->vertices.size();
+    int lifted = 0;
+    for (int i = 0; i < vertices_count; i++) {
+        int current = this->vertices[i].label;
+        if (i != this->source && current > label && current < vertices_count) {
+            this->label_count[current] -= 1;
+            this->label_count[vertices_count + 1] += 1;
+            this->vertices[i].label = vertices_count + 1;
+            this->current_arc[i] = this->first_arc[i];
+            lifted += 1;
+        }
+    }
+    this->statistics.countGap();
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Gap found at label " << label << ", " << lifted << " vertices lifted" << std::endl;
+    }
+    this->derived().onLabelsUpdated();
+}
+
+/**
+ * Replace all the labels with the exact distances in the residual graph: a backward breadth-first
+ * search from the sink labels the vertices that can still reach it, then a second one from the
+ * source labels the remaining vertices with V plus their distance from the source. Vertices that
+ * cannot reach any of them have no excess and get a label that will never be admissible.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::globalRelabel() {
+    typename Statistics::Timer start = this->statistics.startTimer();
+    auto vertices_count = (int) this->vertices.size();
+    int unreached = 2 * vertices_count;
+    for (auto &vertex : this->vertices) {
+        vertex.label = unreached;
+    }
+    std::vector<int> queue;
+    queue.reserve(vertices_count);
+    int roots[] = {this->sink, this->source};
+    int distances[] = {0, vertices_count};
+    for (int r = 0; r < 2; r++) {
+        this->vertices[roots[r]].label = distances[r];
+        queue.clear();
+        queue.push_back(roots[r]);
+        for (int head = 0; head < queue.size(); head++) {
+            int w = queue[head];
+            for (int arc = this->first_arc[w]; arc < this->first_arc[w + 1]; arc++) {
+                // vertex i can reach w if the reverse arc i->w has some residual capacity
+                int i = this->arc_head[arc];
+                if (this->vertices[i].label == unreached && i != this->source && this->isPositive(this->arc_residual[this->arc_reverse[arc]])) {
+                    this->vertices[i].label = this->vertices[w].label + 1;
+                    queue.push_back(i);
+                }
+            }
+        }
+    }
+    this->relabel_work = 0;
+    countLabels();
+    // the labels changed, so the arcs before the current ones may be admissible again
+    this->current_arc.assign(this->first_arc.begin(), this->first_arc.end() - 1);
+    this->statistics.countGlobalRelabel();
+    this->statistics.addGlobalRelabelTime(start);
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Global relabel done" << std::endl;
+    }
+    this->derived().onLabelsUpdated();
+}
+
+/**
+ * Called after the labels of many vertices have been changed at once, so that the variations
+ * of the graph can rebuild the structures that depend on them.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::onLabelsUpdated() {
+    // the basic implementation does not keep any structure based on labels
+}
+
+/**
+ * Called every time a vertex different from the source and the sink receives some flow while
+ * it had no excess. Variations of the graph that keep track of the active vertices provide their own.
+ * @param v index of the vertex that became active.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::activate(int v) {
+    // the basic implementation looks for active vertices from scratch
+}
+
+template <typename Capacity, typename Statistics, typename Derived>
+int PushRelabelGraph<Capacity, Statistics, Derived>::getActiveNode(int s, int t) {
+    // this method must be differently implemented in each variation of
+    // the graph: this basic implementation will not return any vertex.
+    return NO_ACTIVE_NODE_FOUND;
+}
+
+/**
+ * Push the overflowing flow of node u through one of its arcs.
+ * @param u index of the node that have overflowing flow to push.
+ * @param arc index of an admissible arc leaving u.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::push(int u, int arc) {
+    int i = this->arc_head[arc];
+    // the amount of flow that can be sent is equal to the minimum
+    // between the residual capacity of the arc and excess flow.
+    Capacity flow = std::min(this->arc_residual[arc], this->vertices[u].excess);
+    // vertex i becomes active if it had no excess before this push.
+    if (!this->isPositive(this->vertices[i].excess) && i != this->source && i != this->sink) {
+        this->derived().activate(i);
+    }
+    // this flow can be sent from vertex u to vertex i.
+    // the excessive flow in node u must be reduced.
+    this->vertices[u].excess -= flow;
+    // the incoming flow in node i must be added.
+    this->vertices[i].excess += flow;
+    // the residual capacity of the arc u->i must be decreased.
+    this->arc_residual[arc] -= flow;
+    // also the reverse arc must be updated.
+    this->arc_residual[this->arc_reverse[arc]] += flow;
+    this->statistics.countPush(!this->isPositive(this->arc_residual[arc]));
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Flow moved from " << u << " to " << i << " by " << flow << " units" << std::endl;
+    }
+}
+
+/**
+ * Push the excess of node u through its admissible arcs, starting from the current arc of
+ * the vertex, until the excess is gone or the arc list is exhausted. The arcs skipped by the
+ * current arc are not admissible until u is relabeled, so when the list is exhausted the vertex
+ * is relabeled and its current arc goes back to the first one.
+ * @param u index of the node that have overflowing flow to push.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::discharge(int u) {
+    int last_arc = this->first_arc[u + 1];
+    int first_scanned = this->current_arc[u];
+    this->statistics.countDischarge();
+    while (this->isPositive(this->vertices[u].excess) && this->current_arc[u] < last_arc) {
+        int arc = this->current_arc[u];
+        if (this->isPositive(this->arc_residual[arc]) && this->vertices[u].label > this->vertices[this->arc_head[arc]].label) {
+            // the push can be done only if the label of the overflowing
+            // vertex if higher than the label of the adjacent one.
+            // the arc stays the current one until it is saturated.
+            push(u, arc);
+        } else {
+            this->current_arc[u] += 1;
+        }
+    }
+    this->statistics.countArcScans(std::min(this->current_arc[u] + 1, last_arc) - first_scanned);
+    if (this->isPositive(this->vertices[u].excess)) {
+        // no admissible arc found
+        if (Statistics::enabled && this->verbose) {
+            std::cout << "=> No admissible arc found, relabeling node " << u << std::endl;
+        }
+        // relabel the node and scan its arcs again
+        this->derived().relabel(u);
+        this->current_arc[u] = this->first_arc[u];
+        // labels may be too small on large graphs, recompute them once enough work has been done
+        if (this->global_relabel) {
+            this->relabel_work += GLOBAL_RELABEL_BETA + last_arc - this->first_arc[u];
+            if (this->global_relabel_frequency * this->relabel_work > GLOBAL_RELABEL_ALPHA * this->vertices.size() + this->arc_head.size() / 2) {
+                globalRelabel();
+            }
+        }
+    }
+}
+
+template <typename Capacity, typename Statistics, typename Derived>
+bool PushRelabelGraph<Capacity, Statistics, Derived>::relabel(int u) {
+    int previous = this->vertices[u].label;
+    this->statistics.countRelabel();
+    this->statistics.countArcScans(this->first_arc[u + 1] - this->first_arc[u]);
+    // we have to look for the minimum label between the adjacent nodes
+    int minimum = -1;
+    // do the iteration
+    for (int arc = this->first_arc[u]; arc < this->first_arc[u + 1]; arc++) {
+        // ensure that this arc is not full
+        if (this->isPositive(this->arc_residual[arc])) {
+            // obtain the label for this adjacent node
+            int label = this->vertices[this->arc_head[arc]].label;
+            if (minimum == -1 || label < minimum) {
+                // the label of the adjacent node is the minimum
+                minimum = label;
+                this->vertices[u].label = label + 1;
+            }
+        }
+    }
+    // lift the vertices above the old label if it has been left empty
+    if (this->gap_heuristic && minimum != -1) {
+        this->label_count[previous] -= 1;
+        this->label_count[this->vertices[u].label] += 1;
+        if (this->label_count[previous] == 0 && previous < this->vertices.size()) {
+            gap(previous);
+        }
+    }
+    // return if vertex has been relabeled
+    return minimum != -1;
+}
+
+/**
+ * A vertex is active when it has some excess to push. When only the first phase is computed the
+ * vertices with a label of at least V are ignored, since their excess cannot reach the sink.
+ * @param v index of the vertex.
+ * @return if the vertex must still be discharged.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+bool PushRelabelGraph<Capacity, Statistics, Derived>::isActive(int v) {
+    return v != this->source && v != this->sink && this->isPositive(this->vertices[v].excess) &&
+           (!this->phase_one_only || this->vertices[v].label < this->vertices.size());
+}
+
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::setArcCapacity(int arc, Capacity capacity) {
+    Capacity difference = capacity - this->arc_capacity[arc];
+    this->arc_capacity[arc] = capacity;
+    if (!this->solved) {
+        // the residual capacities are reset by the next run
+        return;
+    }
+    bool saturated = !this->isPositive(this->arc_residual[arc]);
+    this->arc_residual[arc] += difference;
+    if (this->isPositive(-this->arc_residual[arc])) {
+        // the arc carries more flow than its new capacity: the flow in excess goes back to
+        // the tail, which becomes active, while the head is left with a deficit.
+        Capacity returned = -this->arc_residual[arc];
+        int u = this->arc_head[this->arc_reverse[arc]];
+        int v = this->arc_head[arc];
+        this->arc_residual[arc] = 0;
+        this->arc_residual[this->arc_reverse[arc]] -= returned;
+        addExcess(u, returned);
+        this->vertices[v].excess -= returned;
+        cancelDeficit(v);
+    } else if (saturated && this->isPositive(this->arc_residual[arc])) {
+        repairArc(arc);
+    }
+}
+
+/**
+ * Add some excess to a vertex, activating it if it had none.
+ * @param v index of the vertex.
+ * @param amount the flow received.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::addExcess(int v, Capacity amount) {
+    bool inactive = !this->isPositive(this->vertices[v].excess);
+    this->vertices[v].excess += amount;
+    if (inactive && this->isPositive(this->vertices[v].excess) && v != this->source && v != this->sink) {
+        this->derived().activate(v);
+    }
+}
+
+/**
+ * An arc got some residual capacity without a push, so its tail may now be too high compared
+ * with its head. Arcs leaving the source are saturated as in the pre-processing, and the head
+ * is lowered if needed to keep the reverse arc valid; otherwise the label of the tail is lowered.
+ * @param arc index of the arc with new residual capacity.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::repairArc(int arc) {
+    int u = this->arc_head[this->arc_reverse[arc]];
+    int v = this->arc_head[arc];
+    if (u == this->source) {
+        Capacity flow = this->arc_residual[arc];
+        this->arc_residual[arc] = 0;
+        this->arc_residual[this->arc_reverse[arc]] += flow;
+        // the head can now send the flow back to the source
+        if (v != this->sink && this->vertices[v].label > this->vertices[u].label + 1) {
+            lowerLabel(v, this->vertices[u].label + 1);
+        }
+        addExcess(v, flow);
+    } else if (u != this->sink && this->vertices[u].label > this->vertices[v].label + 1) {
+        lowerLabel(u, this->vertices[v].label + 1);
+    }
+}
+
+/**
+ * Lower the label of a vertex and then of all the vertices that would become too high compared
+ * with it, visiting backward only the region of the graph where the labels actually change.
+ * Lowered labels are still lower bounds of the distances, so the labeling stays valid.
+ * @param v index of the vertex.
+ * @param label the new label of the vertex.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::lowerLabel(int v, int label) {
+    std::vector<int> queue(1, v);
+    this->vertices[v].label = label;
+    this->current_arc[v] = this->first_arc[v];
+    for (int head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int arc = this->first_arc[w]; arc < this->first_arc[w + 1]; arc++) {
+            int i = this->arc_head[arc];
+            int reverse = this->arc_reverse[arc];
+            if (!this->isPositive(this->arc_residual[reverse])) {
+                continue;
+            }
+            // the arc i->w may have become admissible
+            this->current_arc[i] = this->first_arc[i];
+            if (i == this->source) {
+                repairArc(reverse);
+            } else if (i != this->sink && this->vertices[i].label > this->vertices[w].label + 1) {
+                this->vertices[i].label = this->vertices[w].label + 1;
+                queue.push_back(i);
+            }
+        }
+    }
+}
+
+/**
+ * A vertex received less flow than it sends away: the flow leaving it is reduced until the
+ * deficit is gone, possibly moving the deficit forward along the paths that carry the flow,
+ * until it reaches the sink (reducing the value of the flow) or the source.
+ * @param v index of the vertex with negative excess.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+void PushRelabelGraph<Capacity, Statistics, Derived>::cancelDeficit(int v) {
+    std::vector<int> stack(1, v);
+    while (!stack.empty()) {
+        int w = stack.back();
+        stack.pop_back();
+        for (int arc = this->first_arc[w]; arc < this->first_arc[w + 1] && w != this->source && this->isPositive(-this->vertices[w].excess); arc++) {
+            Capacity flow = this->arc_capacity[arc] - this->arc_residual[arc];
+            if (!this->isPositive(flow)) {
+                continue;
+            }
+            int i = this->arc_head[arc];
+            Capacity cancelled = std::min(flow, -this->vertices[w].excess);
+            bool saturated = !this->isPositive(this->arc_residual[arc]);
+            this->arc_residual[arc] += cancelled;
+            this->arc_residual[this->arc_reverse[arc]] -= cancelled;
+            this->vertices[w].excess += cancelled;
+            this->vertices[i].excess -= cancelled;
+            if (i != this->source && this->isPositive(-this->vertices[i].excess)) {
+                stack.push_back(i);
+            }
+            if (saturated) {
+                repairArc(arc);
+            }
+        }
+    }
+}
+
+/**
+ * Main cycle of the algorithm: discharge the active nodes until there are none left.
+ * @return the excess of the sink, which is the value of the maximum flow.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+Capacity PushRelabelGraph<Capacity, Statistics, Derived>::execute() {
+    typename Statistics::Timer start = this->statistics.startTimer();
+    // print current status after pre-processing
+    if (Statistics::enabled) {
+        this->derived().printCurrentStatus();
+    }
+    // enter the main cycle
+    int cycles = 0;
+    int activeNode = this->derived().getActiveNode(this->source, this->sink);
+    while (activeNode != NO_ACTIVE_NODE_FOUND) {
+        // an active node has been found
+        if (Statistics::enabled && this->verbose) {
+            std::cout << "=> Current active node: " << activeNode << std::endl;
+        }
+        // push the excess away, relabeling the node if needed
+        this->derived().discharge(activeNode);
+        // print current status after each discharge
+        if (Statistics::enabled) {
+            this->derived().printCurrentStatus();
+        }
+        // check for another active node
+        activeNode = this->derived().getActiveNode(this->source, this->sink);
+        cycles += 1;
+    }
+    if (Statistics::enabled && this->verbose) {
+        std::cout << "=> Cycles count: " << cycles << std::endl;
+    }
+    // the preflow and the labels can be reused by a warm start
+    this->solved = true;
+    this->statistics.addDischargeTime(start);
+    // no more active node found, return the maximum flow
+    return this->vertices[this->sink].excess;
+}
+
+template <typename Capacity, typename Statistics, typename Derived>
+Capacity PushRelabelGraph<Capacity, Statistics, Derived>::getMaximumFlow(int s, int t) {
+    this->statistics.reset();
+    typename Statistics::Timer start = this->statistics.startTimer();
+    // the algorithm start pre-processing input data
+    this->derived().preProcess(s, t);
+    // start from the exact distances if the heuristic is enabled
+    if (this->global_relabel) {
+        globalRelabel();
+    }
+    this->statistics.addInitializationTime(start);
+    return execute();
+}
+
+/**
+ * Compute a minimum s-t cut. Only the first phase of the algorithm is executed: once no active
+ * vertex can reach the sink the excess of the sink is already the value of the maximum flow,
+ * so there is no need to return the remaining excess to the source.
+ * @param s index of the source vertex.
+ * @param t index of the sink vertex.
+ * @return the minimum cut between s and t.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+MinimumCut<Capacity> PushRelabelGraph<Capacity, Statistics, Derived>::getMinimumCut(int s, int t) {
+    this->phase_one_only = true;
+    getMaximumFlow(s, t);
+    this->phase_one_only = false;
+    typename Statistics::Timer start = this->statistics.startTimer();
+    MinimumCut<Capacity> cut = this->extractMinimumCut();
+    this->statistics.addCutTime(start);
+    return cut;
+}
+
+/**
+ * Compute again the maximum flow between the source and the sink of the last run, after some
+ * capacities have been updated. The algorithm restarts from the repaired preflow and labels,
+ * so only the region affected by the updates is processed again. Graphs that cannot reuse
+ * their last run are solved from scratch.
+ * @return the value of the maximum flow.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+Capacity PushRelabelGraph<Capacity, Statistics, Derived>::resolveMaximumFlow() {
+    if (!this->solved) {
+        return getMaximumFlow(this->source, this->sink);
+    }
+    if (!this->arcs_built) {
+        this->buildArcs();
+    }
+    // rebuild the structures that depend on labels, some of them may have been lowered
+    this->statistics.reset();
+    this->relabel_work = 0;
+    countLabels();
+    this->derived().onLabelsUpdated();
+    return execute();
+}
+
+/**
+ * Compute again the minimum cut between the source and the sink of the last run,
+ * stopping after the first phase as getMinimumCut does.
+ * @return the minimum cut between the source and the sink.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+MinimumCut<Capacity> PushRelabelGraph<Capacity, Statistics, Derived>::resolveMinimumCut() {
+    this->phase_one_only = true;
+    resolveMaximumFlow();
+    this->phase_one_only = false;
+    typename Statistics::Timer start = this->statistics.startTimer();
+    MinimumCut<Capacity> cut = this->extractMinimumCut();
+    this->statistics.addCutTime(start);
+    return cut;
+}
+
+/**
+ * @return the counters of the last run, all zero when the graph does not collect them.
+ */
+template <typename Capacity, typename Statistics, typename Derived>
+SolverStatistics PushRelabelGraph<Capacity, Statistics, Derived>::getStatistics() {
+    return this->statistics.get();
+}
+
+// instantiate a variation of the graph together with the main loop specialized for it
+#define INSTANTIATE_PUSH_RELABEL_GRAPH(name) \
+    template class PushRelabelGraph<int32_t, NoStatistics, name<int32_t, NoStatistics>>; \
+    template class PushRelabelGraph<int64_t, NoStatistics, name<int64_t, NoStatistics>>; \
+    template class PushRelabelGraph<double, NoStatistics, name<double, NoStatistics>>; \
+    template class PushRelabelGraph<int32_t, CountingStatistics, name<int32_t, CountingStatistics>>; \
+    template class PushRelabelGraph<int64_t, CountingStatistics, name<int64_t, CountingStatistics>>; \
+    template class PushRelabelGraph<double, CountingStatistics, name<double, CountingStatistics>>; \
+    INSTANTIATE_FOR_CAPACITIES_AND_STATISTICS(name)
+
+#endif //ADVANCEDALGORITHMSPROJECT_PUSH_RELABEL_GRAPH_IMPL_H
\ No newline at end of file
@@ -0,0 +1,72 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_SOLVER_SELECTOR_H
+#define ADVANCEDALGORITHMSPROJECT_SOLVER_SELECTOR_H
+
+#include <ostream>
+#include "base_graph.h"
+#include "goldberg_algorthm_solver.h"
+
+/**
+ * Shape of a loaded graph, as seen from the source and the sink of a run. Only the arcs with
+ * some capacity are counted, the reverse arcs of the residual pairs are not part of the input.
+ */
+struct GraphProfile {
+
+    int vertices_count;
+    long long arcs_count;
+
+    // arcs over the V * (V - 1) possible ones
+    double density;
+
+    // smallest and largest capacity of the arcs, equal on unit capacity networks
+    double min_capacity;
+    double max_capacity;
+
+    // arcs leaving the source or entering the sink, the larger of the two
+    int terminal_degree;
+
+    // capacity leaving the source and capacity entering the sink, both bound the flow
+    double source_capacity;
+    double sink_capacity;
+
+    // arcs on the shortest path from the source to the sink, -1 if there is none
+    int sink_distance;
+
+    // distance from the source of the farthest vertex it reaches
+    int source_depth;
+
+    bool isUnitCapacity() const {
+        return this->arcs_count > 0 && this->min_capacity == this->max_capacity;
+    }
+
+    void print(std::ostream &output) const {
+        output << "Vertices: " << vertices_count << std::endl;
+        output << "Arcs: " << arcs_count << std::endl;
+        output << "Density: " << density << std::endl;
+        output << "Capacity range: " << min_capacity << " - " << max_capacity << std::endl;
+        output << "Terminal degree: " << terminal_degree << std::endl;
+        output << "Terminal capacity: " << source_capacity << " - " << sink_capacity << std::endl;
+        output << "Sink distance: " << sink_distance << std::endl;
+        output << "Source depth: " << source_depth << std::endl;
+    }
+
+};
+
+/**
+ * Picks the variation expected to be the fastest on a graph from its profile. The rules and
+ * their thresholds come from the benchmark families (see the comments in select).
+ */
+template <typename Capacity>
+class SolverSelector {
+
+public:
+
+    static GraphProfile getProfile(BaseGraph<Capacity> &graph, int s, int t);
+
+    static SolverType select(const GraphProfile &profile);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_SOLVER_SELECTOR_H
\ No newline at end of file
@@ -0,0 +1,192 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_SOLVER_STATISTICS_H
+#define ADVANCEDALGORITHMSPROJECT_SOLVER_STATISTICS_H
+
+#include <chrono>
+#include <ostream>
+#include "capacity_traits.h"
+
+/**
+ * Counters collected during a run of a solver. The times are wall clock times in nanoseconds:
+ * the initialization covers the saturation of the source arcs and the first global relabel, the
+ * discharge covers the main loop (global relabels included) and the global relabel time is the
+ * one spent recomputing the labels, both at the beginning and during the main loop.
+ */
+struct SolverStatistics {
+
+    long long saturating_pushes;
+    long long non_saturating_pushes;
+    long long relabels;
+    long long gaps;
+    long long global_relabels;
+    long long arc_scans;
+    long long discharges;
+
+    long long initialization_time;
+    long long discharge_time;
+    long long global_relabel_time;
+    long long cut_time;
+
+    void print(std::ostream &output) const {
+        output << "Saturating pushes: " << saturating_pushes << std::endl;
+        output << "Non-saturating pushes: " << non_saturating_pushes << std::endl;
+        output << "Relabels: " << relabels << std::endl;
+        output << "Gaps: " << gaps << std::endl;
+        output << "Global relabels: " << global_relabels << std::endl;
+        output << "Arc scans: " << arc_scans << std::endl;
+        output << "Discharges: " << discharges << std::endl;
+        output << "Initialization time [ns]: " << initialization_time << std::endl;
+        output << "Discharge time [ns]: " << discharge_time << std::endl;
+        output << "Global relabel time [ns]: " << global_relabel_time << std::endl;
+        output << "Cut time [ns]: " << cut_time << std::endl;
+    }
+
+};
+
+/**
+ * Statistics policy of the release builds: every method is empty and the clock is never read,
+ * so the compiler removes the counters, and every branch guarded by enabled, from the hot path.
+ */
+struct NoStatistics {
+
+    static constexpr bool enabled = false;
+
+    typedef int Timer;
+
+    void reset() {}
+
+    void countPush(bool saturating) {}
+
+    void countRelabel() {}
+
+    void countGap() {}
+
+    void countGlobalRelabel() {}
+
+    void countArcScans(long long count) {}
+
+    void countDischarge() {}
+
+    Timer startTimer() const {
+        return 0;
+    }
+
+    void addInitializationTime(Timer start) {}
+
+    void addDischargeTime(Timer start) {}
+
+    void addGlobalRelabelTime(Timer start) {}
+
+    void addCutTime(Timer start) {}
+
+    void merge(const NoStatistics &other) {}
+
+    SolverStatistics get() const {
+        return SolverStatistics {};
+    }
+
+};
+
+/**
+ * Statistics policy that counts every operation and measures the time of each phase.
+ * It also enables the verbose output, which is compiled out of the release builds.
+ */
+struct CountingStatistics {
+
+    static constexpr bool enabled = true;
+
+    typedef std::chrono::steady_clock::time_point Timer;
+
+    SolverStatistics values {};
+
+    void reset() {
+        this->values = SolverStatistics {};
+    }
+
+    void countPush(bool saturating) {
+        if (saturating) {
+            this->values.saturating_pushes += 1;
+        } else {
+            this->values.non_saturating_pushes += 1;
+        }
+    }
+
+    void countRelabel() {
+        this->values.relabels += 1;
+    }
+
+    void countGap() {
+        this->values.gaps += 1;
+    }
+
+    void countGlobalRelabel() {
+        this->values.global_relabels += 1;
+    }
+
+    void countArcScans(long long count) {
+        this->values.arc_scans += count;
+    }
+
+    void countDischarge() {
+        this->values.discharges += 1;
+    }
+
+    Timer startTimer() const {
+        return std::chrono::steady_clock::now();
+    }
+
+    void addInitializationTime(Timer start) {
+        this->values.initialization_time += elapsed(start);
+    }
+
+    void addDischargeTime(Timer start) {
+        this->values.discharge_time += elapsed(start);
+    }
+
+    void addGlobalRelabelTime(Timer start) {
+        this->values.global_relabel_time += elapsed(start);
+    }
+
+    void addCutTime(Timer start) {
+        this->values.cut_time += elapsed(start);
+    }
+
+    /**
+     * Add the counters collected by another instance, used to gather the ones of each thread.
+     * The times are not added, since the threads run at the same time.
+     */
+    void merge(const CountingStatistics &other) {
+        this->values.saturating_pushes += other.values.saturating_pushes;
+        this->values.non_saturating_pushes += other.values.non_saturating_pushes;
+        this->values.relabels += other.values.relabels;
+        this->values.gaps += other.values.gaps;
+        this->values.global_relabels += other.values.global_relabels;
+        this->values.arc_scans += other.values.arc_scans;
+        this->values.discharges += other.values.discharges;
+    }
+
+    SolverStatistics get() const {
+        return this->values;
+    }
+
+private:
+
+    static long long elapsed(Timer start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+};
+
+// the push-relabel graphs are compiled once for each capacity type and statistics policy
+#define INSTANTIATE_FOR_CAPACITIES_AND_STATISTICS(name) \
+    template class name<int32_t, NoStatistics>; \
+    template class name<int64_t, NoStatistics>; \
+    template class name<double, NoStatistics>; \
+    template class name<int32_t, CountingStatistics>; \
+    template class name<int64_t, CountingStatistics>; \
+    template class name<double, CountingStatistics>;
+
+#endif //ADVANCEDALGORITHMSPROJECT_SOLVER_STATISTICS_H
\ No newline at end of file
@@ -0,0 +1,75 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include "thread_pool.h"
+
+/**
+ * Start the worker threads, the calling thread counts as one of them.
+ * @param threads_count total number of threads that execute each task.
+ */
+ThreadPool::ThreadPool(int threads_count) {
+    this->generation = 0;
+    this->pending = 0;
+    this->stopping = false;
+    for (int i = 1; i < threads_count; i++) {
+        this->workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->task_ready.notify_all();
+    for (auto &worker : this->workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const {
+    return (int) this->workers.size() + 1;
+}
+
+void ThreadPool::work(int thread_id) {
+    long seen = 0;
+    while (true) {
+        std::function<void(int)> current;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->task_ready.wait(lock, [this, seen] { return this->stopping || this->generation != seen; });
+            if (this->stopping) {
+                return;
+            }
+            seen = this->generation;
+            current = this->task;
+        }
+        current(thread_id);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->pending -= 1;
+        }
+        this->task_done.notify_one();
+    }
+}
+
+/**
+ * Execute the task on every thread of the pool and wait until all of them are done.
+ * @param task function receiving the index of the thread, between 0 and size() - 1.
+ */
+void ThreadPool::run(const std::function<void(int)> &task) {
+    if (this->workers.empty()) {
+        task(0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = task;
+        this->pending = (int) this->workers.size();
+        this->generation += 1;
+    }
+    this->task_ready.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->task_done.wait(lock, [this] { return this->pending == 0; });
+}
\ No newline at end of file
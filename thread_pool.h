@@ -0,0 +1,49 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_THREAD_POOL_H
+#define ADVANCEDALGORITHMSPROJECT_THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * Fixed set of threads that execute the same task together (fork-join): the calling thread
+ * takes part in the work as thread 0 and run() returns once every thread has finished.
+ */
+class ThreadPool {
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable task_ready;
+    std::condition_variable task_done;
+
+    std::function<void(int)> task;
+
+    // incremented each time a new task is published to the workers
+    long generation;
+
+    // number of workers that have not finished the current task yet
+    int pending;
+
+    bool stopping;
+
+    void work(int thread_id);
+
+public:
+
+    explicit ThreadPool(int threads_count);
+
+    virtual ~ThreadPool();
+
+    int size() const;
+
+    void run(const std::function<void(int)> &task);
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_THREAD_POOL_H
\ No newline at end of file
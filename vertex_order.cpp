@@ -0,0 +1,180 @@
+//
+// Created by andrea on 09/09/18.
+//
+#include <algorithm>
+#include "vertex_order.h"
+#include "graph_builder.h"
+
+/**
+ * Compute the new order of the vertices of a graph, whose arcs are built if needed.
+ * @param graph the graph to reorder.
+ * @param ordering the order of the vertices.
+ * @param t the sink vertex, the root of the breadth-first order.
+ */
+template <typename Capacity>
+VertexOrder<Capacity>::VertexOrder(BaseGraph<Capacity> &graph, VertexOrdering ordering, int t) {
+    if (!graph.arcs_built) {
+        graph.buildArcs();
+    }
+    int n = (int) graph.vertices.size();
+    this->original_id.reserve(n);
+    if (ordering == BFS_ORDER) {
+        orderByDistance(graph, t);
+    } else if (ordering == RCM_ORDER) {
+        orderByCuthillMcKee(graph);
+    } else {
+        for (int v = 0; v < n; v++) {
+            this->original_id.push_back(v);
+        }
+    }
+    this->new_id.assign(n, 0);
+    for (int i = 0; i < n; i++) {
+        this->new_id[this->original_id[i]] = i;
+    }
+}
+
+/**
+ * Number the vertices in breadth-first order from the sink, on the arcs of both directions, so
+ * the vertices with close distance labels are close in memory. The vertices that are not
+ * connected to the sink follow, in the same order from each of them.
+ */
+template <typename Capacity>
+void VertexOrder<Capacity>::orderByDistance(const BaseGraph<Capacity> &graph, int t) {
+    int n = (int) graph.vertices.size();
+    std::vector<bool> visited(n, false);
+    for (int root = -1; root < n; root++) {
+        int start = root == -1 ? t : root;
+        if (visited[start]) {
+            continue;
+        }
+        visited[start] = true;
+        size_t head = this->original_id.size();
+        this->original_id.push_back(start);
+        for (; head < this->original_id.size(); head++) {
+            int w = this->original_id[head];
+            for (int arc = graph.first_arc[w]; arc < graph.first_arc[w + 1]; arc++) {
+                int i = graph.arc_head[arc];
+                if (!visited[i]) {
+                    visited[i] = true;
+                    this->original_id.push_back(i);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Reverse Cuthill-McKee order: each connected component is visited in breadth-first order from
+ * one of its vertices with the smallest degree, adding the neighbors of each vertex by increasing
+ * degree, and the whole order is reversed at the end.
+ */
+template <typename Capacity>
+void VertexOrder<Capacity>::orderByCuthillMcKee(const BaseGraph<Capacity> &graph) {
+    int n = (int) graph.vertices.size();
+    auto degree = [&graph](int v) {
+        return graph.first_arc[v + 1] - graph.first_arc[v];
+    };
+    // the vertices by increasing degree, the first one not visited yet starts the next component
+    std::vector<int> by_degree(n);
+    for (int v = 0; v < n; v++) {
+        by_degree[v] = v;
+    }
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&degree](int a, int b) {
+        return degree(a) < degree(b);
+    });
+    std::vector<bool> visited(n, false);
+    std::vector<int> neighbors;
+    for (int root : by_degree) {
+        if (visited[root]) {
+            continue;
+        }
+        visited[root] = true;
+        size_t head = this->original_id.size();
+        this->original_id.push_back(root);
+        for (; head < this->original_id.size(); head++) {
+            int w = this->original_id[head];
+            neighbors.clear();
+            for (int arc = graph.first_arc[w]; arc < graph.first_arc[w + 1]; arc++) {
+                int i = graph.arc_head[arc];
+                if (!visited[i]) {
+                    visited[i] = true;
+                    neighbors.push_back(i);
+                }
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(), [&degree](int a, int b) {
+                return degree(a) < degree(b);
+            });
+            this->original_id.insert(this->original_id.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+    std::reverse(this->original_id.begin(), this->original_id.end());
+}
+
+template <typename Capacity>
+int VertexOrder<Capacity>::getVerticesCount() const {
+    return (int) this->original_id.size();
+}
+
+/**
+ * @param v a vertex of the original graph.
+ * @return its id in the reordered graph.
+ */
+template <typename Capacity>
+int VertexOrder<Capacity>::getNewVertex(int v) const {
+    return this->new_id[v];
+}
+
+/**
+ * @param v a vertex of the reordered graph.
+ * @return its id in the original graph.
+ */
+template <typename Capacity>
+int VertexOrder<Capacity>::getOriginalVertex(int v) const {
+    return this->original_id[v];
+}
+
+/**
+ * Load the arcs of a graph into an empty one in the new order, with the same settings.
+ * The capacities are copied, the flow of the last run is not.
+ * @param graph the graph in the original order.
+ * @param target a graph of the same size.
+ */
+template <typename Capacity>
+void VertexOrder<Capacity>::apply(BaseGraph<Capacity> &graph, BaseGraph<Capacity> &target) const {
+    int n = (int) graph.vertices.size();
+    GraphBuilder<Capacity> builder(n);
+    for (int w = 0; w < n; w++) {
+        for (int arc = graph.first_arc[w]; arc < graph.first_arc[w + 1]; arc++) {
+            if (graph.isPositive(graph.arc_capacity[arc])) {
+                builder.addEdge(this->new_id[w], this->new_id[graph.arc_head[arc]], graph.arc_capacity[arc]);
+            }
+        }
+    }
+    builder.build(target);
+    graph.copySettings(target);
+}
+
+/**
+ * Translate a minimum cut of the reordered graph back to the original vertices, sorting the
+ * source side and the arcs by their original ids.
+ * @param cut the minimum cut of the reordered graph.
+ * @return the same cut on the original vertices.
+ */
+template <typename Capacity>
+MinimumCut<Capacity> VertexOrder<Capacity>::restoreCut(const MinimumCut<Capacity> &cut) const {
+    MinimumCut<Capacity> restored;
+    restored.value = cut.value;
+    for (int v : cut.source_side) {
+        restored.source_side.push_back(this->original_id[v]);
+    }
+    std::sort(restored.source_side.begin(), restored.source_side.end());
+    for (auto &arc : cut.arcs) {
+        restored.arcs.emplace_back(this->original_id[arc.u], this->original_id[arc.v], arc.capacity);
+    }
+    std::sort(restored.arcs.begin(), restored.arcs.end(), [](const CutArc<Capacity> &a, const CutArc<Capacity> &b) {
+        return a.u != b.u ? a.u < b.u : a.v < b.v;
+    });
+    return restored;
+}
+
+INSTANTIATE_FOR_CAPACITIES(VertexOrder)
\ No newline at end of file
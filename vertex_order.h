@@ -0,0 +1,52 @@
+//
+// Created by andrea on 09/09/18.
+//
+
+#ifndef ADVANCEDALGORITHMSPROJECT_VERTEX_ORDER_H
+#define ADVANCEDALGORITHMSPROJECT_VERTEX_ORDER_H
+
+#include <vector>
+#include "base_graph.h"
+
+enum VertexOrdering {
+    ORIGINAL_ORDER,
+    BFS_ORDER,
+    RCM_ORDER
+};
+
+/**
+ * New numbering of the vertices of a graph, chosen so that the vertices close in the graph are
+ * close in memory too: their labels and excesses, and their ranges of arcs, share the cache lines
+ * when a vertex is discharged. The breadth-first order from the sink follows the distance labels,
+ * the reverse Cuthill-McKee order keeps the neighbors of each vertex in a narrow band of ids.
+ *
+ * The graph is rebuilt in the new order, and the vertices given to the solver and returned by it
+ * are translated at its boundary, so the callers only see the original ids.
+ */
+template <typename Capacity>
+class VertexOrder {
+
+    // position of each original vertex in the new order, and the inverse permutation
+    std::vector<int> new_id;
+    std::vector<int> original_id;
+
+    void orderByDistance(const BaseGraph<Capacity> &graph, int t);
+
+    void orderByCuthillMcKee(const BaseGraph<Capacity> &graph);
+
+public:
+
+    VertexOrder(BaseGraph<Capacity> &graph, VertexOrdering ordering, int t);
+
+    int getVerticesCount() const;
+
+    int getNewVertex(int v) const;
+
+    int getOriginalVertex(int v) const;
+
+    void apply(BaseGraph<Capacity> &graph, BaseGraph<Capacity> &target) const;
+
+    MinimumCut<Capacity> restoreCut(const MinimumCut<Capacity> &cut) const;
+};
+
+#endif //ADVANCEDALGORITHMSPROJECT_VERTEX_ORDER_H
\ No newline at end of file